@@ -0,0 +1,37 @@
+/**
+ * @file Allocations.h
+ * @brief Counts the heap allocations of each thread, to check that the engine plays games without allocating.
+ *
+ * The engine replaces the global operator new and delete with versions that forward to malloc and free and count
+ * every allocation in a thread-local counter, so counting costs one increment and takes no lock.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Allocations {
+
+/**
+ * @brief Returns the number of heap allocations the calling thread has made so far.
+ */
+std::uint64_t count() noexcept;
+
+/**
+ * @brief Counts the allocations the calling thread makes during its own lifetime.
+ */
+class Scope {
+public:
+    Scope() noexcept
+        : start(count()) {}
+
+    /**
+     * @brief Returns the allocations made since the scope began.
+     */
+    std::uint64_t allocations() const noexcept { return count() - start; }
+
+private:
+    std::uint64_t start;
+};
+
+}
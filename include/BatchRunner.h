@@ -0,0 +1,124 @@
+/**
+ * @file BatchRunner.h
+ * @brief Declaration of the parallel batch runner for headless simulations.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Stats.h"
+#include "Strategy.h"
+#include "const.h"
+
+/**
+ * @brief Describes a batch of independent games to simulate.
+ */
+struct BatchConfig {
+    short num_players = 2;
+    short starting_round = Config::MAX_STARTING_ROUND;
+
+    /**
+     * @brief Number of decks in the shoe. 0 uses the fewest decks that deal every hand.
+     */
+    short num_decks = 0;
+
+    bool shuffle_enabled = true;
+    std::uint64_t num_games = 1;
+
+    /**
+     * @brief Number of worker threads. 0 uses one thread per hardware core.
+     */
+    unsigned num_threads = 0;
+
+    /**
+     * @brief Master seed. Game i of the batch is seeded with stream_seed(seed, i), so the results only depend on the
+     * seed and not on the number of threads.
+     */
+    std::uint64_t seed = 0;
+
+    /**
+     * @brief If not empty, worker t records every game it plays to the binary log <record_path>.<t>.
+     */
+    std::string record_path;
+
+    /**
+     * @brief Strategy of the player in each seat; seats past the end play GreedyStrategy. Search strategies are
+     * reseeded for every game from the game's stream and the seat.
+     */
+    std::vector<Strategy> strategies;
+
+    /**
+     * @brief If set, run_batch fails if any game after the first of each worker allocated from the heap. Search
+     * strategies on more than one thread start their threads at every decision, so they always fail the check.
+     */
+    bool check_allocations = false;
+};
+
+/**
+ * @brief Aggregated outcome of a batch of games, in constant memory however many games it covers.
+ *
+ * Every worker records its own games into its own result, and the results are merged once the workers are done;
+ * merging is associative, so the totals do not depend on how the games were split.
+ */
+struct BatchResult {
+    std::uint64_t games = 0;
+    std::uint64_t rounds = 0;
+    std::uint64_t turns = 0;
+    std::uint64_t reshuffles = 0;
+    std::uint64_t stalemates = 0;
+
+    /**
+     * @brief Heap allocations made while playing games, not counting the first game of each worker, which sets up
+     * the worker's game.
+     */
+    std::uint64_t allocations = 0;
+
+    /**
+     * @brief Number of games won by the player in each seat.
+     */
+    std::array<std::uint64_t, Config::MAX_PLAYER_COUNT> wins {};
+
+    Distribution rounds_per_game;
+    Distribution turns_per_game;
+    Distribution reshuffles_per_game;
+
+    /**
+     * @brief Adds one finished game.
+     * @param final_rounds Rounds each seat had left at the end; seats at 0 won.
+     */
+    void record_game(std::uint64_t game_rounds, std::uint64_t game_turns, std::uint64_t game_reshuffles,
+                     std::uint64_t game_stalemates, std::span<short const> final_rounds) noexcept;
+
+    /**
+     * @brief Adds the results of another batch to this one.
+     * @param other The results to merge in.
+     */
+    void merge(BatchResult const& other) noexcept;
+};
+
+/**
+ * @brief Plays every game of the batch on a pool of worker threads.
+ *
+ * Workers claim games in chunks from a shared counter, so faster workers simply play more games. Each worker owns
+ * its event sink and decks, and every game shuffles from its own counter-derived stream; the only shared state is the
+ * counter, and per-worker results are merged once all workers have finished. Each worker sets up one Game and
+ * resets it between games, so once its first game is over a worker plays without allocating.
+ *
+ * @param config The batch to run.
+ * @return The merged results of all games.
+ * @throws std::runtime_error if config.check_allocations is set and a game allocated after warm-up, or if a log file
+ * cannot be opened or written in full.
+ */
+BatchResult run_batch(BatchConfig const& config);
+
+/**
+ * @brief Prints the per-game distributions and the win rate of every seat, with 95% confidence intervals.
+ * @param result The results to report.
+ * @param num_players Number of seats to report wins for.
+ */
+void print_report(BatchResult const& result, short num_players);
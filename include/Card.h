@@ -6,53 +6,97 @@
 #pragma once
 
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <format>
 #include <iostream>
 #include <string>
+#include <string_view>
 
+/**
+ * @brief A playing card packed into a single byte: the rank in the low four bits and the suit in the two bits above.
+ */
 class Card {
 public:
     /**
      * @brief Strongly-typed card ranks. Ace = 1, King = 13.
      */
-    enum class Rank : short { ACE = 1, TWO, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN, JACK, QUEEN, KING };
+    enum class Rank : std::uint8_t { ACE = 1, TWO, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN, JACK, QUEEN, KING };
 
     /**
      * @brief Strongly-typed card suits. 0=Spades, 1=Hearts, 2=Clubs, 3=Diamonds
      */
-    enum class Suit : short { SPADES = 0, HEARTS, CLUBS, DIAMONDS };
+    enum class Suit : std::uint8_t { SPADES = 0, HEARTS, CLUBS, DIAMONDS };
 
     /**
      * @brief Default constructor for Card (Ace of Spades).
      */
-
-    Card() noexcept;
+    constexpr Card() noexcept
+        : bits(pack(Rank::ACE, Suit::SPADES)) {}
 
     /**
      * @brief Initializes Card to specified rank and suit.
      * @param rank_in The rank of the card (enum Rank).
      * @param suit_in The suit of the card (enum Suit).
      */
-    Card(Rank rank_in, Suit suit_in) noexcept;
+    constexpr Card(Rank rank_in, Suit suit_in) noexcept
+        : bits(pack(rank_in, suit_in)) {}
 
     /**
      * @brief Gets the rank of the card.
      * @return The rank as enum Rank.
      */
-    Rank get_rank() const noexcept;
+    constexpr Rank get_rank() const noexcept { return static_cast<Rank>(bits & RANK_MASK); }
 
     /**
      * @brief Gets the suit of the card.
      * @return The suit as enum Suit.
      */
-    Suit get_suit() const noexcept;
+    constexpr Suit get_suit() const noexcept { return static_cast<Suit>(bits >> SUIT_SHIFT); }
 
     /**
-     * @brief Returns true if card is a face card (Jack, Queen, King or Ace).
+     * @brief Returns true if card is a face card (Jack, Queen, King).
      * @return True if face card, false otherwise.
      */
-    bool is_face() const noexcept;
+    constexpr bool is_face() const noexcept { return (bits & RANK_MASK) >= static_cast<std::uint8_t>(Rank::JACK); }
+
+    /**
+     * @brief Returns the packed one-byte representation of the card.
+     */
+    constexpr std::uint8_t get_bits() const noexcept { return bits; }
+
+    /**
+     * @brief Rebuilds a card from the value returned by get_bits().
+     * @param bits_in The packed representation.
+     * @return The card.
+     */
+    static constexpr Card from_bits(std::uint8_t bits_in) noexcept {
+        Card card;
+        card.bits = bits_in;
+        return card;
+    }
+
+    /**
+     * @brief Returns the rank as it is displayed: A, 2 to 10, J, Q or K.
+     */
+    static constexpr std::string_view rank_name(Rank rank) noexcept {
+        return RANK_NAMES[static_cast<std::size_t>(rank)];
+    }
+
+    /**
+     * @brief Returns the suit as a Unicode symbol: ♠, ♥, ♣ or ♦.
+     */
+    static constexpr std::string_view suit_symbol(Suit suit) noexcept {
+        return SUIT_SYMBOLS[static_cast<std::size_t>(suit)];
+    }
+
+    /**
+     * @brief Returns the suit as a single ASCII letter: S, H, C or D.
+     */
+    static constexpr std::string_view suit_letter(Suit suit) noexcept {
+        return SUIT_LETTERS[static_cast<std::size_t>(suit)];
+    }
 
     /**
      * @brief Returns the rank as a string (for display).
@@ -66,10 +110,25 @@ public:
     static std::string suit_to_string(Suit suit);
 
 private:
-    Rank rank;
-    Suit suit;
+    // Indexed by the enum values; rank 0 does not exist
+    static constexpr std::array<std::string_view, 14> RANK_NAMES
+        = { "", "A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K" };
+    static constexpr std::array<std::string_view, 4> SUIT_SYMBOLS = { "♠", "♥", "♣", "♦" };
+    static constexpr std::array<std::string_view, 4> SUIT_LETTERS = { "S", "H", "C", "D" };
+
+    static constexpr std::uint8_t RANK_MASK = 0x0F;
+    static constexpr int SUIT_SHIFT = 4;
+
+    static constexpr std::uint8_t pack(Rank rank_in, Suit suit_in) noexcept {
+        return static_cast<std::uint8_t>(static_cast<std::uint8_t>(rank_in)
+                                         | (static_cast<std::uint8_t>(suit_in) << SUIT_SHIFT));
+    }
+
+    std::uint8_t bits;
 };
 
+static_assert(sizeof(Card) == 1, "Card must stay packed into a single byte");
+
 
 /**
  * @brief Suits in order from lowest suit to highest suit.
@@ -135,10 +194,60 @@ bool operator==(Card const& lhs, Card const& rhs) noexcept;
  */
 bool operator!=(Card const& lhs, Card const& rhs) noexcept;
 
+/**
+ * @brief Parses the format spec shared by the Card and Hand formatters: the string spec for fill, alignment and width,
+ * optionally ended by "a" for ASCII suit letters instead of Unicode suit symbols. The "a" stands where a presentation
+ * type would, so "a" and ">5a" are ASCII suits, while "a^5" is Unicode suits centred with 'a' as the fill. A width
+ * taken from an argument cannot be combined with "a".
+ * @param base String formatter that parses the fill, alignment and width.
+ * @param ascii Set to true for ASCII.
+ * @return The end of the spec.
+ */
+constexpr auto parse_suit_style(auto& ctx, std::formatter<std::string_view>& base, bool& ascii) {
+    auto end = ctx.begin();
+    while (end != ctx.end() && *end != '}') {
+        ++end;
+    }
+    ascii = end != ctx.begin() && *(end - 1) == 'a';
+    if (!ascii) {
+        return base.parse(ctx);
+    }
+    std::format_parse_context standard(std::string_view(ctx.begin(), end - 1));
+    if (base.parse(standard) != standard.end()) {
+        throw std::format_error("Invalid format spec for a card");
+    }
+    ctx.advance_to(end);
+    return end;
+}
+
+/**
+ * @brief Writes a card to the output, as "10♠", or as "10S" with the spec "a", after any string spec for fill,
+ * alignment and width. The text is put together on the stack and copied out in one piece.
+ */
 template <>
-struct std::formatter<Card> : std::formatter<std::string> {
-    auto format(Card const& c, auto& ctx) const noexcept {
-        std::string s = Card::rank_to_string(c.get_rank()) + Card::suit_to_string(c.get_suit());
-        return std::formatter<std::string>::format(s, ctx);
+struct std::formatter<Card> : std::formatter<std::string_view> {
+    /**
+     * @brief Longest text of a card: a two-digit rank and a three-byte suit symbol.
+     */
+    static constexpr std::size_t MAX_SIZE = 5;
+
+    bool ascii = false;
+
+    constexpr auto parse(auto& ctx) { return parse_suit_style(ctx, *this, ascii); }
+
+    /**
+     * @brief Writes the text of a card to a buffer of at least MAX_SIZE characters.
+     * @return The end of the text.
+     */
+    static constexpr char* render(Card const& c, bool ascii_suit, char* out) noexcept {
+        out = std::ranges::copy(Card::rank_name(c.get_rank()), out).out;
+        return std::ranges::copy(ascii_suit ? Card::suit_letter(c.get_suit()) : Card::suit_symbol(c.get_suit()), out)
+            .out;
     }
-};
\ No newline at end of file
+
+    auto format(Card const& c, auto& ctx) const {
+        std::array<char, MAX_SIZE> text;
+        char const* const end = render(c, ascii, text.data());
+        return std::formatter<std::string_view>::format(std::string_view(text.data(), end), ctx);
+    }
+};
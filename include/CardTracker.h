@@ -0,0 +1,223 @@
+/**
+ * @file CardTracker.h
+ * @brief Declaration of the CardTracker, which keeps track of the cards nobody can see.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "Card.h"
+#include "Deck.h"
+#include "EventSink.h"
+#include "Hand.h"
+
+/**
+ * @brief Counts, per rank, the cards nobody can see: those face down in a hand or in the draw pile.
+ *
+ * The tracker is an event sink and is updated by the events of a game, so every query is answered from counters
+ * without looking at the deck or the hands. From the point of view of any player all unseen cards are alike, so the
+ * next card drawn is equally likely to be any of them.
+ */
+class CardTracker final : public EventSink {
+public:
+    CardTracker() noexcept;
+
+    /**
+     * @brief The counters of a CardTracker as plain bytes.
+     */
+    struct Snapshot {
+        std::array<std::uint8_t, NUM_RANKS + 1> unseen_by_rank;
+        std::array<std::uint8_t, NUM_RANKS + 1> discarded_by_rank;
+        std::uint16_t unseen_count;
+        short num_decks;
+        std::array<Card, Deck::MAX_SHOE_SIZE> discard_pile;
+        std::uint16_t discard_size;
+    };
+
+    void save(Snapshot& snapshot) const noexcept {
+        snapshot.unseen_by_rank = unseen_by_rank;
+        snapshot.discarded_by_rank = discarded_by_rank;
+        snapshot.unseen_count = unseen_count;
+        snapshot.num_decks = num_decks;
+        snapshot.discard_pile = discard_pile;
+        snapshot.discard_size = discard_size;
+    }
+
+    void restore(Snapshot const& snapshot) noexcept {
+        unseen_by_rank = snapshot.unseen_by_rank;
+        discarded_by_rank = snapshot.discarded_by_rank;
+        unseen_count = snapshot.unseen_count;
+        num_decks = snapshot.num_decks;
+        discard_pile = snapshot.discard_pile;
+        discard_size = snapshot.discard_size;
+    }
+
+    /**
+     * @brief Returns how many cards of the given rank are unseen.
+     */
+    int unseen(Card::Rank rank) const noexcept { return unseen_by_rank[static_cast<std::size_t>(rank)]; }
+
+    /**
+     * @brief Returns how many cards are unseen.
+     */
+    int unseen_total() const noexcept { return unseen_count; }
+
+    /**
+     * @brief Returns the discard pile, top card last.
+     */
+    std::span<Card const> get_discard_pile() const noexcept { return { discard_pile.data(), discard_size }; }
+
+    /**
+     * @brief Returns the probability that the next card drawn can be placed in one of the hand's face-down positions.
+     */
+    double fill_probability(Hand const& hand) const noexcept {
+        if (unseen_count == 0) {
+            return 0.0;
+        }
+        int fitting = 0;
+        for (std::size_t i = 0; i < hand.size(); ++i) {
+            fitting += hand.is_showing(i) ? 0 : unseen_by_rank[i + 1];
+        }
+        return static_cast<double>(fitting) / unseen_count;
+    }
+
+    /**
+     * @brief Forgets everything seen so far, as at the start of a round.
+     */
+    void clear() noexcept;
+
+    void on_game_setup(std::span<Player const>, short, short num_decks_in) noexcept override {
+        num_decks = num_decks_in;
+        clear();
+    }
+    void on_game_start() noexcept override {}
+    void on_deal(Player const&, Card const&) noexcept override {}
+    void on_deal_complete(Player const&, short) noexcept override {}
+    void on_first_discard(Card const& card) noexcept override;
+    void on_turn(Player const&) noexcept override {}
+    void on_turn_state(Player const&, Hand const&, Card const&) noexcept override {}
+    void on_take_discard(Player const&, Card const& card) noexcept override {
+        --discarded_by_rank[rank_of(card)];
+        --discard_size;
+    }
+    void on_draw(Player const&, Card const& card) noexcept override {
+        --unseen_by_rank[rank_of(card)];
+        --unseen_count;
+    }
+    void on_card_played(Card const&, Card const& replaced) noexcept override {
+        // Cards are only ever placed on face-down positions, so the replaced card is revealed
+        --unseen_by_rank[rank_of(replaced)];
+        --unseen_count;
+    }
+    void on_card_not_playable(Card const&) noexcept override {}
+    void on_discard(Player const&, Card const& card) noexcept override { push_discard(card); }
+    void on_reshuffle() noexcept override;
+    void on_stalemate() noexcept override {}
+    void on_round_over(std::span<Player const>) noexcept override { clear(); }
+    void on_game_over(std::span<Player const>) noexcept override { clear(); }
+    void on_final_scores(std::span<Player const>) noexcept override {}
+
+private:
+    static std::size_t rank_of(Card const& card) noexcept { return static_cast<std::size_t>(card.get_rank()); }
+
+    /**
+     * @brief Puts a card on top of the discard pile.
+     */
+    void push_discard(Card const& card) noexcept {
+        ++discarded_by_rank[rank_of(card)];
+        discard_pile[discard_size++] = card;
+    }
+
+    /**
+     * @brief Unseen cards, indexed by rank value. Slot 0 is unused.
+     */
+    std::array<std::uint8_t, NUM_RANKS + 1> unseen_by_rank;
+
+    /**
+     * @brief Cards in the discard pile, indexed by rank value. They become unseen again on a reshuffle.
+     */
+    std::array<std::uint8_t, NUM_RANKS + 1> discarded_by_rank;
+
+    std::uint16_t unseen_count = 0;
+
+    /**
+     * @brief Number of decks in the shoe, so every rank starts with NUM_SUITS unseen cards per deck.
+     */
+    short num_decks = 1;
+
+    /**
+     * @brief The discard pile, top card last, so taking the discard reveals which card is on top next.
+     */
+    std::array<Card, Deck::MAX_SHOE_SIZE> discard_pile;
+    std::uint16_t discard_size = 0;
+};
+
+
+/**
+ * @brief Updates a CardTracker with every event, then forwards the event to another sink.
+ *
+ * Unlike a TeeSink in front of the tracker, the tracker's handlers are called directly and inlined, so tracking adds
+ * no indirect calls to the engine's event path.
+ */
+class TrackingSink final : public EventSink {
+public:
+    TrackingSink(CardTracker& tracker_in, EventSink& sink_in) noexcept
+        : tracker(tracker_in)
+        , sink(sink_in) {}
+
+    void on_game_setup(std::span<Player const> players, short starting_round, short num_decks) noexcept override {
+        tracker.on_game_setup(players, starting_round, num_decks);
+        sink.on_game_setup(players, starting_round, num_decks);
+    }
+    void on_game_start() noexcept override { sink.on_game_start(); }
+    void on_deal(Player const& player, Card const& card) noexcept override { sink.on_deal(player, card); }
+    void on_deal_complete(Player const& player, short num_cards) noexcept override {
+        sink.on_deal_complete(player, num_cards);
+    }
+    void on_first_discard(Card const& card) noexcept override {
+        tracker.on_first_discard(card);
+        sink.on_first_discard(card);
+    }
+    void on_turn(Player const& player) noexcept override { sink.on_turn(player); }
+    void on_turn_state(Player const& player, Hand const& hand, Card const& top_discard) noexcept override {
+        sink.on_turn_state(player, hand, top_discard);
+    }
+    void on_take_discard(Player const& player, Card const& card) noexcept override {
+        tracker.on_take_discard(player, card);
+        sink.on_take_discard(player, card);
+    }
+    void on_draw(Player const& player, Card const& card) noexcept override {
+        tracker.on_draw(player, card);
+        sink.on_draw(player, card);
+    }
+    void on_card_played(Card const& card, Card const& replaced) noexcept override {
+        tracker.on_card_played(card, replaced);
+        sink.on_card_played(card, replaced);
+    }
+    void on_card_not_playable(Card const& card) noexcept override { sink.on_card_not_playable(card); }
+    void on_discard(Player const& player, Card const& card) noexcept override {
+        tracker.on_discard(player, card);
+        sink.on_discard(player, card);
+    }
+    void on_reshuffle() noexcept override {
+        tracker.on_reshuffle();
+        sink.on_reshuffle();
+    }
+    void on_stalemate() noexcept override { sink.on_stalemate(); }
+    void on_round_over(std::span<Player const> players) noexcept override {
+        tracker.on_round_over(players);
+        sink.on_round_over(players);
+    }
+    void on_game_over(std::span<Player const> players) noexcept override {
+        tracker.on_game_over(players);
+        sink.on_game_over(players);
+    }
+    void on_final_scores(std::span<Player const> players) noexcept override { sink.on_final_scores(players); }
+
+private:
+    CardTracker& tracker;
+    EventSink& sink;
+};
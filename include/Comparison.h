@@ -0,0 +1,121 @@
+/**
+ * @file Comparison.h
+ * @brief Head-to-head comparison of two strategies on common random numbers, stopped by a sequential test.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "Stats.h"
+#include "Strategy.h"
+#include "const.h"
+
+/**
+ * @brief Describes a comparison between strategies A and B.
+ *
+ * The strategies play two-player games in pairs. With mirrored pairs, both games of a pair deal from the same seed
+ * with the seats swapped, so each strategy gets the other's cards and the luck of the deal mostly cancels out of the
+ * pair's score. Without, the two games deal from independent seeds, which is what separate batches of games amount
+ * to.
+ */
+struct ComparisonConfig {
+    Strategy a;
+    Strategy b;
+    short starting_round = Config::MAX_STARTING_ROUND;
+
+    /**
+     * @brief Deal both games of a pair from the same seed, swapping seats.
+     */
+    bool mirrored = true;
+
+    /**
+     * @brief Smallest difference worth resolving: the test tells A's mean score of 0.5 + margin or 0.5 - margin
+     * apart from 0.5.
+     */
+    double margin = 0.05;
+
+    /**
+     * @brief Probability of declaring a difference when there is none, for each direction.
+     */
+    double alpha = 0.05;
+
+    /**
+     * @brief Probability of missing a difference of margin.
+     */
+    double beta = 0.05;
+
+    /**
+     * @brief Pairs played before the test may stop, so the variance it uses is settled.
+     */
+    std::uint64_t min_pairs = 100;
+
+    /**
+     * @brief Pairs played at most; the comparison is unresolved if the test has not stopped by then.
+     */
+    std::uint64_t max_pairs = 1'000'000;
+
+    /**
+     * @brief Number of worker threads. 0 uses one thread per hardware core.
+     */
+    unsigned num_threads = 0;
+
+    /**
+     * @brief Master seed. Pair p deals from streams derived from seed and p, so the outcome does not depend on the
+     * threads.
+     */
+    std::uint64_t seed = 0;
+
+    /**
+     * @brief If set, called from the calling thread after each batch of pairs with the pairs rated so far.
+     */
+    std::function<void(std::uint64_t pairs, RunningStats const& pair_scores)> on_progress;
+};
+
+/**
+ * @brief Outcome of a comparison.
+ */
+struct ComparisonResult {
+    enum class Verdict : std::uint8_t { A_STRONGER, B_STRONGER, NO_DIFFERENCE, UNRESOLVED };
+
+    Verdict verdict = Verdict::UNRESOLVED;
+
+    /**
+     * @brief A's score in every pair counted by the test: the mean of its two games, where a game scores 1 for
+     * finishing with fewer rounds left than the opponent, 0.5 for as many, 0 for more.
+     */
+    RunningStats pair_scores;
+
+    /**
+     * @brief A's score in every game of those pairs.
+     */
+    RunningStats game_scores;
+
+    std::uint64_t wins_a = 0;
+    std::uint64_t wins_b = 0;
+
+    /**
+     * @brief Log-likelihood ratios of the test for A stronger and of the test for B stronger.
+     */
+    double llr_a = 0.0;
+    double llr_b = 0.0;
+
+    /**
+     * @brief Variance of a pair's score if its games had been independent, over the variance measured: how many
+     * times more pairs independent games would need for the same precision.
+     */
+    double variance_reduction() const noexcept;
+};
+
+/**
+ * @brief Plays pairs of games between A and B until the comparison is resolved or config.max_pairs is reached.
+ *
+ * Two sequential tests run side by side on A's pair scores, one of mean 0.5 against 0.5 + margin and one of 0.5
+ * against 0.5 - margin: the comparison stops when either finds its strategy stronger, or when both have accepted
+ * that neither is stronger by margin. Pairs are played in parallel in batches and fed to the tests in order, so the
+ * verdict and the number of pairs it took only depend on the seed.
+ *
+ * @throws std::invalid_argument if the comparison cannot be run as described.
+ */
+ComparisonResult compare_strategies(ComparisonConfig const& config);
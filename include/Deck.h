@@ -5,21 +5,88 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <span>
 #include <string>
-#include <vector>
 
 #include "Card.h"
+#include "Random.h"
+#include "const.h"
 
 
+/**
+ * @brief A shoe of one or more standard decks with a draw pile and a discard pile.
+ *
+ * Both piles live in one fixed buffer of get_shoe_size() slots that is used as a ring. The buffer is sized for the
+ * largest shoe, so changing the number of decks never allocates. The draw pile occupies
+ * draw_count slots starting at draw_begin, with its top card last. The discard pile occupies the discard_count slots
+ * just before draw_begin, with its top card first, and grows downwards into the free slots left by cards that are in
+ * players' hands. Moving the discard pile back underneath the draw pile therefore only moves draw_begin.
+ */
 class Deck {
 public:
+    /**
+     * @brief Number of Cards in one standard deck.
+     */
+    static constexpr int CARDS_PER_DECK = NUM_SUITS * NUM_RANKS;
+
+    /**
+     * @brief Number of Cards in the largest shoe.
+     */
+    static constexpr int MAX_SHOE_SIZE = Config::MAX_DECKS * CARDS_PER_DECK;
+
+    /**
+     * @brief How shuffle() does its work.
+     */
+    enum class ShuffleMode : std::uint8_t {
+        /**
+         * @brief shuffle() permutes the whole draw pile right away.
+         */
+        EAGER,
+        /**
+         * @brief shuffle() only marks the draw pile as shuffled; each deal_one() then performs the one Fisher-Yates
+         * step that picks the card it returns. Deals are distributed exactly as with EAGER, but the cost is
+         * proportional to the number of cards actually drawn.
+         */
+        LAZY
+    };
+
+    /**
+     * @brief The full state of a Deck as plain bytes: both piles, the shuffle generator and the shuffle mode. A script
+     * set with set_script() is not part of it.
+     */
+    struct Snapshot {
+        std::array<Card, MAX_SHOE_SIZE> cards;
+        std::array<std::uint64_t, 4> rng_state;
+        short num_decks;
+        std::uint16_t shoe_size;
+        std::uint16_t draw_begin;
+        std::uint16_t draw_count;
+        std::uint16_t discard_count;
+        std::uint16_t unshuffled_count;
+        ShuffleMode shuffle_mode;
+    };
+
     /**
      * @brief Initializes the Deck to be in the following standard order:
      * The cards of the lowest suit arranged from lowest rank to highest rank, followed by the cards of the next lowest
-     * suit in order from lowest to highest rank, and so on.
+     * suit in order from lowest to highest rank, and so on. The shuffle generator is seeded from std::random_device.
      */
     Deck() noexcept;
 
+    /**
+     * @brief Initializes the Deck in standard order with a shuffle generator seeded from the given seed.
+     * @param seed Seed for this Deck's random number generator.
+     */
+    explicit Deck(std::uint64_t seed) noexcept;
+
+    /**
+     * @brief Restarts the shuffle generator from the given seed, so the following shuffles are reproducible.
+     * @param seed Seed for this Deck's random number generator.
+     */
+    void seed(std::uint64_t seed) noexcept;
+
     /**
      * @brief Returns the next card in the deck and removes it from the deck. If the deck is empty, it is reset first.
      * @return The next Card in the deck.
@@ -27,21 +94,76 @@ public:
     Card deal_one() noexcept;
 
     /**
-     * @brief Resets the deck by moving all cards from the discard pile back into the draw pile, and then discarding the
-     * top card.
+     * @brief Resets the deck by moving all cards from the discard pile back underneath the draw pile, except for the
+     * top card, which stays in the discard pile. The recycled cards are dealt newest first, and only they are touched.
      */
     void reset() noexcept;
 
     /**
-     * @brief Resets the deck to a full, ordered deck.
+     * @brief Resets the deck to a full, ordered shoe by copying in the standard order once per deck. The state of the
+     * shuffle generator is kept.
      */
     void redeal() noexcept;
 
     /**
-     * @brief Shuffles the Deck using a cryptographically secure random number generator.
+     * @brief Copies the state of the Deck into a snapshot.
+     */
+    void save(Snapshot& snapshot) const noexcept;
+
+    /**
+     * @brief Returns the Deck to a saved state, so it deals exactly as it did after the save. Clears any script.
+     */
+    void restore(Snapshot const& snapshot) noexcept;
+
+    /**
+     * @brief Changes the number of decks in the shoe and redeals it.
+     * @param num_decks Number of decks, between 1 and Config::MAX_DECKS.
+     * @throws std::invalid_argument if num_decks is out of range.
+     */
+    void set_num_decks(short num_decks);
+
+    /**
+     * @brief Returns the number of decks in the shoe.
+     */
+    short get_num_decks() const noexcept { return num_decks; }
+
+    /**
+     * @brief Returns the number of cards in the full shoe.
+     */
+    int get_shoe_size() const noexcept { return shoe_size; }
+
+    /**
+     * @brief Returns the standard order of one deck that redeal() restores, bottom card first.
+     */
+    static std::array<Card, NUM_SUITS * NUM_RANKS> const& standard_order() noexcept;
+
+    /**
+     * @brief Shuffles the draw pile using this Deck's own random number generator.
      */
     void shuffle() noexcept;
 
+    /**
+     * @brief Selects how subsequent calls to shuffle() are carried out.
+     * @param mode The shuffle mode.
+     */
+    void set_shuffle_mode(ShuffleMode mode) noexcept;
+
+    /**
+     * @brief Makes the following deals return the given cards in order, each one taken out of the draw pile wherever
+     * it is. Used to reproduce a recorded game regardless of shuffling. Once the script runs out, or names a card that
+     * is not in the draw pile, dealing continues normally.
+     * @param order The cards to deal, in order. Must outlive the script.
+     */
+    void set_script(std::span<Card const> order) noexcept;
+
+    /**
+     * @brief Replaces the contents of both piles. Used to set up a hypothetical deck consistent with what a player has
+     * seen. The draw pile is treated as already shuffled.
+     * @param draw_pile The new draw pile, with its top card last.
+     * @param discard_pile The new discard pile, with its top card first.
+     */
+    void set_piles(std::span<Card const> draw_pile, std::span<Card const> discard_pile) noexcept;
+
     /**
      * @brief Returns true if there are no more cards left in the draw pile.
      * @return True if draw pile is empty, false otherwise.
@@ -55,11 +177,17 @@ public:
     bool discard_pile_empty() const noexcept;
 
     /**
-     * @brief Returns the number of cards in the Deck.
-     * @return The number of cards in the Deck.
+     * @brief Returns the number of cards in the draw pile.
+     * @return The number of cards in the draw pile.
      */
     int size() const noexcept;
 
+    /**
+     * @brief Returns the number of cards in the discard pile.
+     * @return The number of cards in the discard pile.
+     */
+    int discard_size() const noexcept;
+
     /**
      * @brief Returns the top card in the discard pile without removing it.
      * @return The top Card in the discard pile.
@@ -79,11 +207,6 @@ public:
     Card const take_discard();
 
 private:
-    /**
-     * @brief Default number of Cards in the Deck.
-     */
-    inline static constexpr int DEFAULT_DECK_SIZE = NUM_SUITS * NUM_RANKS;
-
     // Use Card::Rank and Card::Suit for value arrays
     static constexpr Card::Suit SUIT_VALUES_BY_WEIGHT[4]
         = { Card::Suit::SPADES, Card::Suit::HEARTS, Card::Suit::CLUBS, Card::Suit::DIAMONDS };
@@ -93,12 +216,51 @@ private:
             Card::Rank::JACK, Card::Rank::QUEEN, Card::Rank::KING };
 
     /**
-     * @brief Cards in the Deck.
+     * @brief Shuffle generator. Each Deck owns one, so Decks on different threads never share state.
+     */
+    Rng rng;
+
+    /**
+     * @brief Maps a position relative to draw_begin to a slot in the buffer.
+     */
+    std::size_t wrap(int position) const noexcept {
+        return static_cast<std::size_t>(position < 0            ? position + shoe_size
+                                        : position >= shoe_size ? position - shoe_size
+                                                                : position);
+    }
+
+    /**
+     * @brief Storage for the draw and discard piles. Only the first shoe_size slots are used.
+     */
+    std::array<Card, MAX_SHOE_SIZE> cards;
+
+    short num_decks = 1;
+    std::uint16_t shoe_size = CARDS_PER_DECK;
+
+    /**
+     * @brief Slot of the bottom card of the draw pile.
+     */
+    std::uint16_t draw_begin = 0;
+
+    /**
+     * @brief Number of cards in the draw pile.
+     */
+    std::uint16_t draw_count = 0;
+
+    /**
+     * @brief Number of cards in the discard pile.
      */
-    std::vector<Card> draw_pile;
+    std::uint16_t discard_count = 0;
+
+    /**
+     * @brief Number of cards at the top of the draw pile that a lazy shuffle has not yet put in place.
+     */
+    std::uint16_t unshuffled_count = 0;
+
+    ShuffleMode shuffle_mode = ShuffleMode::EAGER;
 
     /**
-     * @brief Cards in the discard pile.
+     * @brief Cards still to be dealt from the script, if any.
      */
-    std::vector<Card> discard_pile;
+    std::span<Card const> script;
 };
@@ -0,0 +1,254 @@
+/**
+ * @file EventSink.h
+ * @brief Declaration of the EventSink interface and the standard sinks.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "Card.h"
+#include "Logger.h"
+#include "const.h"
+
+class Hand;
+class Player;
+
+/**
+ * @brief Receives everything that happens during a game.
+ *
+ * The engine never formats or prints by itself; it reports events to a sink, and the sink decides what (if
+ * anything) to do with them.
+ */
+class EventSink {
+public:
+    /**
+     * @brief Called before anything else, with the players in seat order, the starting round and the number of decks
+     * in the shoe.
+     */
+    virtual void on_game_setup(std::span<Player const> players, short starting_round, short num_decks) noexcept = 0;
+
+    /**
+     * @brief Called once before the first turn of the game.
+     */
+    virtual void on_game_start() noexcept = 0;
+
+    /**
+     * @brief Called for every card dealt to a player's hand.
+     */
+    virtual void on_deal(Player const& player, Card const& card) noexcept = 0;
+
+    /**
+     * @brief Called after a player has been dealt all of their cards for the round.
+     */
+    virtual void on_deal_complete(Player const& player, short num_cards) noexcept = 0;
+
+    /**
+     * @brief Called when the card that starts the discard pile has been dealt.
+     */
+    virtual void on_first_discard(Card const& card) noexcept = 0;
+
+    /**
+     * @brief Called when the game hands the turn to a player.
+     */
+    virtual void on_turn(Player const& player) noexcept = 0;
+
+    /**
+     * @brief Called when a player starts deciding, with their hand and the top of the discard pile.
+     */
+    virtual void on_turn_state(Player const& player, Hand const& hand, Card const& top_discard) noexcept = 0;
+
+    /**
+     * @brief Called when a player takes the top card of the discard pile.
+     */
+    virtual void on_take_discard(Player const& player, Card const& card) noexcept = 0;
+
+    /**
+     * @brief Called when a player draws a card from the draw pile.
+     */
+    virtual void on_draw(Player const& player, Card const& card) noexcept = 0;
+
+    /**
+     * @brief Called for every card placed into a hand, together with the card it replaced.
+     */
+    virtual void on_card_played(Card const& card, Card const& replaced) noexcept = 0;
+
+    /**
+     * @brief Called when a card that cannot be placed is played.
+     */
+    virtual void on_card_not_playable(Card const& card) noexcept = 0;
+
+    /**
+     * @brief Called when a player ends their turn by discarding.
+     */
+    virtual void on_discard(Player const& player, Card const& card) noexcept = 0;
+
+    /**
+     * @brief Called when the draw pile has run out and the discard pile, except for its top card, becomes the new
+     * draw pile.
+     */
+    virtual void on_reshuffle() noexcept = 0;
+
+    /**
+     * @brief Called when a round is abandoned because no player can place a card anymore.
+     */
+    virtual void on_stalemate() noexcept = 0;
+
+    /**
+     * @brief Called after a round in which nobody reached round 0.
+     */
+    virtual void on_round_over(std::span<Player const> players) noexcept = 0;
+
+    /**
+     * @brief Called once a player has reached round 0.
+     */
+    virtual void on_game_over(std::span<Player const> players) noexcept = 0;
+
+    /**
+     * @brief Called with the final standings after the game is over.
+     */
+    virtual void on_final_scores(std::span<Player const> players) noexcept = 0;
+
+    /**
+     * @brief Virtual destructor for EventSink.
+     */
+    virtual ~EventSink() noexcept {}
+};
+
+
+/**
+ * @brief Discards every event. Used for headless simulation.
+ */
+class NullSink : public EventSink {
+public:
+    void on_game_setup(std::span<Player const>, short, short) noexcept override {}
+    void on_game_start() noexcept override {}
+    void on_deal(Player const&, Card const&) noexcept override {}
+    void on_deal_complete(Player const&, short) noexcept override {}
+    void on_first_discard(Card const&) noexcept override {}
+    void on_turn(Player const&) noexcept override {}
+    void on_turn_state(Player const&, Hand const&, Card const&) noexcept override {}
+    void on_take_discard(Player const&, Card const&) noexcept override {}
+    void on_draw(Player const&, Card const&) noexcept override {}
+    void on_card_played(Card const&, Card const&) noexcept override {}
+    void on_card_not_playable(Card const&) noexcept override {}
+    void on_discard(Player const&, Card const&) noexcept override {}
+    void on_reshuffle() noexcept override {}
+    void on_stalemate() noexcept override {}
+    void on_round_over(std::span<Player const>) noexcept override {}
+    void on_game_over(std::span<Player const>) noexcept override {}
+    void on_final_scores(std::span<Player const>) noexcept override {}
+};
+
+
+/**
+ * @brief Writes the human-readable play-by-play to a logger: the deals and every step of every turn at DEBUG level,
+ * the start, stalemates, round results and final scores at INFO level.
+ */
+class TextSink : public EventSink {
+public:
+    explicit TextSink(Logger& logger_in) noexcept
+        : logger(logger_in) {}
+
+    void on_game_setup(std::span<Player const>, short, short) noexcept override {}
+    void on_game_start() noexcept override;
+    void on_deal(Player const& player, Card const& card) noexcept override;
+    void on_deal_complete(Player const& player, short num_cards) noexcept override;
+    void on_first_discard(Card const&) noexcept override {}
+    void on_turn(Player const& player) noexcept override;
+    void on_turn_state(Player const& player, Hand const& hand, Card const& top_discard) noexcept override;
+    void on_take_discard(Player const& player, Card const& card) noexcept override;
+    void on_draw(Player const& player, Card const& card) noexcept override;
+    void on_card_played(Card const& card, Card const& replaced) noexcept override;
+    void on_card_not_playable(Card const& card) noexcept override;
+    void on_discard(Player const& player, Card const& card) noexcept override;
+    void on_reshuffle() noexcept override {}
+    void on_stalemate() noexcept override;
+    void on_round_over(std::span<Player const> players) noexcept override;
+    void on_game_over(std::span<Player const> players) noexcept override;
+    void on_final_scores(std::span<Player const> players) noexcept override;
+
+private:
+    Logger& logger;
+
+    /**
+     * @brief Reused to build messages of several lines.
+     */
+    std::string text;
+};
+
+
+/**
+ * @brief Counts events across any number of games without formatting anything.
+ */
+class CountingSink : public EventSink {
+public:
+    void on_game_setup(std::span<Player const>, short, short) noexcept override {}
+    void on_game_start() noexcept override { ++games; }
+    void on_deal(Player const&, Card const&) noexcept override { ++cards_dealt; }
+    void on_deal_complete(Player const&, short) noexcept override {}
+    void on_first_discard(Card const&) noexcept override {}
+    void on_turn(Player const&) noexcept override { ++turns; }
+    void on_turn_state(Player const&, Hand const&, Card const&) noexcept override {}
+    void on_take_discard(Player const&, Card const&) noexcept override { ++discards_taken; }
+    void on_draw(Player const&, Card const&) noexcept override { ++draws; }
+    void on_card_played(Card const&, Card const&) noexcept override { ++cards_played; }
+    void on_card_not_playable(Card const&) noexcept override {}
+    void on_discard(Player const&, Card const&) noexcept override {}
+    void on_reshuffle() noexcept override { ++reshuffles; }
+    void on_stalemate() noexcept override { ++stalemates; }
+    void on_round_over(std::span<Player const>) noexcept override { ++rounds; }
+    void on_game_over(std::span<Player const>) noexcept override { ++rounds; }
+    void on_final_scores(std::span<Player const> players) noexcept override;
+
+    std::uint64_t games = 0;
+    std::uint64_t rounds = 0;
+    std::uint64_t turns = 0;
+    std::uint64_t cards_dealt = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t discards_taken = 0;
+    std::uint64_t cards_played = 0;
+    std::uint64_t reshuffles = 0;
+    std::uint64_t stalemates = 0;
+
+    /**
+     * @brief Number of games won by the player in each seat.
+     */
+    std::array<std::uint64_t, Config::MAX_PLAYER_COUNT> wins {};
+};
+
+
+/**
+ * @brief Forwards every event to two other sinks, in order.
+ */
+class TeeSink : public EventSink {
+public:
+    TeeSink(EventSink& first_in, EventSink& second_in) noexcept
+        : first(first_in)
+        , second(second_in) {}
+
+    void on_game_setup(std::span<Player const> players, short starting_round, short num_decks) noexcept override;
+    void on_game_start() noexcept override;
+    void on_deal(Player const& player, Card const& card) noexcept override;
+    void on_deal_complete(Player const& player, short num_cards) noexcept override;
+    void on_first_discard(Card const& card) noexcept override;
+    void on_turn(Player const& player) noexcept override;
+    void on_turn_state(Player const& player, Hand const& hand, Card const& top_discard) noexcept override;
+    void on_take_discard(Player const& player, Card const& card) noexcept override;
+    void on_draw(Player const& player, Card const& card) noexcept override;
+    void on_card_played(Card const& card, Card const& replaced) noexcept override;
+    void on_card_not_playable(Card const& card) noexcept override;
+    void on_discard(Player const& player, Card const& card) noexcept override;
+    void on_reshuffle() noexcept override;
+    void on_stalemate() noexcept override;
+    void on_round_over(std::span<Player const> players) noexcept override;
+    void on_game_over(std::span<Player const> players) noexcept override;
+    void on_final_scores(std::span<Player const> players) noexcept override;
+
+private:
+    EventSink& first;
+    EventSink& second;
+};
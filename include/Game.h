@@ -1,30 +1,247 @@
 #pragma once
 
+#include <bitset>
+#include <cstdint>
+#include <generator>
+#include <optional>
+#include <span>
 #include <vector>
 
+#include "CardTracker.h"
 #include "Deck.h"
+#include "EventSink.h"
+#include "GameSnapshot.h"
 #include "Player.h"
+#include "const.h"
+
+/**
+ * @brief What happened in one step of a game played through Game::steps().
+ */
+struct GameStep {
+    enum class Kind : std::uint8_t {
+        /**
+         * @brief The player in seat plays an ExternalStrategy and it is their turn: pass their decision to
+         * Game::decide() before resuming.
+         */
+        DECISION,
+        /**
+         * @brief The player in seat took a turn.
+         */
+        TURN,
+        /**
+         * @brief A round is over and the next one has been dealt.
+         */
+        ROUND_OVER,
+        /**
+         * @brief The game is over and the scores are out. Always the last step.
+         */
+        GAME_OVER
+    };
+
+    Kind kind = Kind::TURN;
+    std::uint8_t seat = 0;
+
+    /**
+     * @brief For TURN: whether the player took the discard rather than drew.
+     */
+    bool took_discard = false;
+
+    /**
+     * @brief For TURN: whether the player completed their hand, which ends the round.
+     */
+    bool completed = false;
+};
 
 /**
  * @brief Represents a game engine.
  *
  * The Game class manages the overall game flow, including player turns, dealing cards,
- * and handling the deck and discard pile.
+ * and handling the deck and discard pile. Constructing a Game only sets it up; call play() to run it, or iterate
+ * over steps() to run it one turn at a time.
  */
 class Game {
 public:
-    Game(std::vector<Player*> const& players_in, short starting_round_in, bool shuffle_enabled_in);
-    void deal(std::vector<short> cards_per_player);
+    /**
+     * @throws std::invalid_argument if there are no players or more than Config::MAX_PLAYER_COUNT, or if the hands do
+     * not fit in a shoe of Config::MAX_DECKS decks.
+     */
+    Game(std::vector<Player> players_in, short starting_round_in, bool shuffle_enabled_in, EventSink& sink_in);
+    Game(std::vector<Player> players_in, short starting_round_in, bool shuffle_enabled_in, EventSink& sink_in,
+         std::uint64_t seed);
+    Game(Game const&) = delete;
+    Game& operator=(Game const&) = delete;
+    void play();
+
+    /**
+     * @brief Puts the game back at its start for another game at the same table: every player back at the starting
+     * round with an empty hand, and the deck reseeded and back in order. The players, the shoe and every buffer are
+     * kept, so a game reset and played again allocates nothing.
+     * @param seed Seed of the deck for the next game.
+     */
+    void reset(std::uint64_t seed) noexcept;
+
+    /**
+     * @brief Gives the player in a seat a new strategy, such as a search strategy reseeded for the next game.
+     */
+    void set_strategy(std::size_t seat, Strategy strategy) noexcept;
+
+    /**
+     * @brief Plays the game one turn at a time: starts it, then yields a step after every turn and at the end of every
+     * round, and stops after the GAME_OVER step. Between steps the game is paused and holds no thread, so one thread
+     * can interleave the steps of any number of games, and a player with an ExternalStrategy can be asked for their
+     * decision at a DECISION step. The events reach the sink exactly as with play().
+     *
+     * The game must outlive the generator, and only one generator may run a game at a time.
+     * @throws std::logic_error when resumed after a DECISION step without a call to decide().
+     */
+    std::generator<GameStep> steps();
+
+    /**
+     * @brief Plays on one step at a time from where the game stands, such as after restore(): steps() without the
+     * start. A game restored at a DECISION step yields that DECISION step again first.
+     * @throws std::logic_error when resumed after a DECISION step without a call to decide().
+     */
+    std::generator<GameStep> resume();
+
+    /**
+     * @brief Answers the last DECISION step: true to take the top discard, false to draw.
+     */
+    void decide(bool take_discard) noexcept { decision = take_discard; }
+
+    /**
+     * @brief Sets the game up and deals the first round, which play_round() then plays. play() is start() followed by
+     * play_round() until the game is over and print_scores().
+     */
+    void start();
+    void set_deck_order(std::span<Card const> order) noexcept;
+
+    /**
+     * @brief Deals from a shoe of the given number of decks instead of the smallest one that holds every hand.
+     * @throws std::invalid_argument if num_decks is above Config::MAX_DECKS or the shoe cannot deal every hand.
+     */
+    void set_num_decks(short num_decks);
+
+    /**
+     * @brief Copies the state of the game into a snapshot. Call it between turns of a game in progress: after start()
+     * or play_round(), or at any step of steps() or resume() but GAME_OVER. A game restored from the snapshot carries
+     * on with play_round() or resume().
+     */
+    void save(GameSnapshot& snapshot) const noexcept;
+
+    /**
+     * @brief Puts the game back in a saved state, so it plays on exactly as it did after the save. Player names and
+     * strategies are kept; a search strategy picks up its count of decisions from the snapshot, so it samples the same
+     * rollouts again.
+     * @throws std::invalid_argument if the snapshot was taken with a different number of players.
+     */
+    void restore(GameSnapshot const& snapshot);
+
+    /**
+     * @brief Returns the fewest decks whose shoe can deal starting_round cards to every player plus the first discard.
+     */
+    static short min_decks(std::size_t num_players, short starting_round) noexcept;
+
+    /**
+     * @brief Deals every player the number of cards in their entry of cards_per_player.
+     */
+    void deal(std::span<short const> cards_per_player);
+
+    /**
+     * @brief Turns over the first discard once the hands are dealt, which opens the round.
+     */
     void discard_first_card();
-    std::vector<bool> take_turns();
+
+    /**
+     * @brief Plays turns until a player completes their hand or the round stalemates, from wherever the round stands.
+     * @return Bit i is set if the player in seat i completed their hand.
+     */
+    std::bitset<Config::MAX_PLAYER_COUNT> take_turns();
     bool game_over() const noexcept;
     bool play_round();
-    void print_scores() const;
-    ~Game();
+    void print_scores();
+    size_t count_face_up() const noexcept;
+    std::span<Player const> get_players() const noexcept;
+    CardTracker const& get_tracker() const noexcept;
+    Deck const& get_deck() const noexcept;
 
 private:
+    /**
+     * @brief steps() when from_start, resume() otherwise.
+     */
+    std::generator<GameStep> play_steps(bool from_start);
+
+    /**
+     * @brief Starts the bookkeeping of a round: the seat to play, the stalemate check and the turn count.
+     */
+    void begin_round() noexcept;
+
+    /**
+     * @brief Returns true once a player has completed their hand and the last seat has had its turn.
+     */
+    bool round_over() const noexcept;
+
+    /**
+     * @brief Starts the turn of the player in seat: gets the deck ready and reports the turn and the player's hand.
+     * take_turns() and steps() play every turn through begin_turn() and finish_turn().
+     * @return false if the round is stalemated instead.
+     */
+    bool begin_turn();
+
+    /**
+     * @brief Plays the turn begun by begin_turn() with the player's decision and moves on to the next seat.
+     */
+    void finish_turn(bool take_discard) noexcept;
+
+    /**
+     * @brief Gets the deck ready for the next turn, reshuffling the discards once the draw pile is out.
+     * @return false if the round is stalemated instead.
+     */
+    bool prepare_turn();
+
+    /**
+     * @brief Closes the bookkeeping of a round.
+     */
+    void end_round() noexcept;
+
+    /**
+     * @brief Scores a finished round and deals the next one.
+     * @param players_won Bit i is set if the player in seat i completed their hand.
+     * @return false if the game is over instead.
+     */
+    bool next_round(std::bitset<Config::MAX_PLAYER_COUNT> players_won);
+
     Deck deck;
-    std::vector<Player*> players;
+    std::vector<Player> players;
     short starting_round;
     bool shuffle_enabled;
+    EventSink& sink;
+
+    /**
+     * @brief Sees every event before the sink does, so strategies can query it during their turn.
+     */
+    CardTracker tracker;
+
+    /**
+     * @brief Updates the tracker and forwards events to the sink. The engine reports every event here.
+     */
+    TrackingSink events;
+
+    /**
+     * @brief State of the round in progress, kept here so steps() can pause between turns.
+     */
+    size_t face_up = 0;
+    short idle_reshuffles = 0;
+    std::uint64_t round_turns = 0;
+    std::size_t seat = 0;
+    std::bitset<Config::MAX_PLAYER_COUNT> players_won;
+
+    /**
+     * @brief Set between begin_turn() and finish_turn(), while the turn of seat waits for its decision.
+     */
+    bool turn_begun = false;
+
+    /**
+     * @brief Decision passed to decide() for the turn steps() is paused at.
+     */
+    std::optional<bool> decision;
 };
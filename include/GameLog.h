@@ -0,0 +1,325 @@
+/**
+ * @file GameLog.h
+ * @brief Compact binary game recording: the record format, a buffered writer, a recording event sink and a
+ * memory-mapped reader.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Card.h"
+#include "EventSink.h"
+#include "MappedFile.h"
+#include "Strategy.h"
+#include "const.h"
+
+/**
+ * @brief Record types of the game log.
+ *
+ * Every record is one tag byte followed by a fixed number of payload bytes (see record_size). Cards are stored with
+ * Card::get_bits() and players by seat index. TAKE_DISCARD, DRAW, PLAY and DISCARD belong to the player of the
+ * preceding TURN record. Multi-byte numbers are little endian.
+ */
+enum class LogEvent : std::uint8_t {
+    GAME_SETUP,    // num_players, starting_round
+    DEAL,          // seat, card
+    FIRST_DISCARD, // card
+    TURN,          // seat
+    TAKE_DISCARD,  // card
+    DRAW,          // card
+    PLAY,          // card, replaced card
+    DISCARD,       // card
+    STALEMATE,     //
+    ROUND_WON,     // seat
+    ROUND_END,     //
+    GAME_END,      //
+    SHOE,          // num_decks; follows GAME_SETUP only for shoes of more than one deck
+    STRATEGY,      // seat, kind, threads (4), rollouts (4), time budget in us (8), seed (8), decisions (8); follows
+                   // GAME_SETUP for every seat that does not play greedily, see encode_strategy
+    COUNT
+};
+
+/**
+ * @brief Returns the number of payload bytes that follow the tag of a record.
+ */
+constexpr std::size_t record_size(LogEvent event) noexcept {
+    constexpr std::array<std::uint8_t, static_cast<std::size_t>(LogEvent::COUNT)> SIZES
+        = { 2, 2, 1, 1, 1, 1, 2, 1, 0, 1, 0, 0, 1, 34 };
+    return SIZES[static_cast<std::size_t>(event)];
+}
+
+/**
+ * @brief Largest payload of any record.
+ */
+inline constexpr std::size_t MAX_RECORD_SIZE = 34;
+
+/**
+ * @brief One decoded record. Unused payload bytes are zero.
+ */
+struct LogRecord {
+    LogEvent event;
+    std::uint8_t a;
+    std::uint8_t b;
+
+    /**
+     * @brief The whole payload, of which a and b are the first two bytes. Points into the log.
+     */
+    std::span<std::uint8_t const> payload;
+};
+
+/**
+ * @brief Magic bytes and format version at the start of every log file.
+ */
+inline constexpr std::array<char, 7> LOG_MAGIC = { 'G', 'A', 'R', 'B', 'L', 'O', 'G' };
+inline constexpr std::uint8_t LOG_VERSION = 2;
+
+/**
+ * @brief Encodes the strategy of a seat as the payload of a STRATEGY record. The kind is the index of the strategy's
+ * alternative in the Strategy variant; the numbers after it describe a SearchStrategy and are zero for the others.
+ */
+std::array<std::uint8_t, MAX_RECORD_SIZE> encode_strategy(std::uint8_t seat, Strategy const& strategy) noexcept;
+
+/**
+ * @brief Decodes the payload of a STRATEGY record, except for the seat.
+ * @throws std::runtime_error if the kind is not a strategy.
+ */
+Strategy decode_strategy(std::span<std::uint8_t const> payload);
+
+
+/**
+ * @brief Appends records to a log through a large in-memory buffer.
+ *
+ * Writing to a file flushes the buffer in big blocks; a writer constructed without a path keeps everything in memory.
+ */
+class LogWriter {
+public:
+    /**
+     * @brief Creates an in-memory log.
+     */
+    LogWriter();
+
+    /**
+     * @brief Creates (or truncates) the log file at path_in and writes the file header.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit LogWriter(std::string const& path_in);
+
+    LogWriter(LogWriter const&) = delete;
+    LogWriter& operator=(LogWriter const&) = delete;
+
+    /**
+     * @brief Flushes and closes the file. Use close() to find out whether the log was written in full.
+     */
+    ~LogWriter() noexcept;
+
+    /**
+     * @brief Appends one record of up to two payload bytes.
+     */
+    void write(LogEvent event, std::uint8_t a = 0, std::uint8_t b = 0) noexcept {
+        if (buffer.size() + 3 > BUFFER_SIZE && file != nullptr) {
+            flush();
+        }
+        buffer.push_back(static_cast<std::uint8_t>(event));
+        std::size_t const size = record_size(event);
+        if (size > 0) {
+            buffer.push_back(a);
+        }
+        if (size > 1) {
+            buffer.push_back(b);
+        }
+    }
+
+    /**
+     * @brief Appends one record with its whole payload, record_size(event) bytes of it.
+     */
+    void write(LogEvent event, std::span<std::uint8_t const> payload) noexcept {
+        std::size_t const size = record_size(event);
+        if (buffer.size() + 1 + size > BUFFER_SIZE && file != nullptr) {
+            flush();
+        }
+        buffer.push_back(static_cast<std::uint8_t>(event));
+        buffer.insert(buffer.end(), payload.begin(), payload.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+
+    /**
+     * @brief Writes the buffered records to the file. Does nothing for in-memory logs. If the file does not take all
+     * of them, such as on a full disk, the records are dropped and failed() is set from then on.
+     */
+    void flush() noexcept;
+
+    /**
+     * @brief Returns true if a write to the file has failed, so the log is missing records.
+     */
+    bool failed() const noexcept { return write_failed; }
+
+    /**
+     * @brief Flushes and closes the file. Does nothing for in-memory logs or a file that is already closed.
+     * @throws std::runtime_error if any write to the file failed.
+     */
+    void close();
+
+    /**
+     * @brief Returns the contents of an in-memory log, including the header.
+     */
+    std::span<std::uint8_t const> data() const noexcept { return buffer; }
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+    std::FILE* file = nullptr;
+    std::string path;
+    std::vector<std::uint8_t> buffer;
+    bool write_failed = false;
+};
+
+
+/**
+ * @brief Event sink that records games into a LogWriter.
+ */
+class RecordingSink : public EventSink {
+public:
+    explicit RecordingSink(LogWriter& writer_in) noexcept
+        : writer(writer_in) {}
+
+    void on_game_setup(std::span<Player const> players, short starting_round, short num_decks) noexcept override;
+    void on_game_start() noexcept override {}
+    void on_deal(Player const& player, Card const& card) noexcept override;
+    void on_deal_complete(Player const&, short) noexcept override {}
+    void on_first_discard(Card const& card) noexcept override;
+    void on_turn(Player const& player) noexcept override;
+    void on_turn_state(Player const&, Hand const&, Card const&) noexcept override {}
+    void on_take_discard(Player const& player, Card const& card) noexcept override;
+    void on_draw(Player const& player, Card const& card) noexcept override;
+    void on_card_played(Card const& card, Card const& replaced) noexcept override;
+    void on_card_not_playable(Card const&) noexcept override {}
+    void on_discard(Player const& player, Card const& card) noexcept override;
+    void on_reshuffle() noexcept override {}
+    void on_stalemate() noexcept override;
+    void on_round_over(std::span<Player const> players) noexcept override;
+    void on_game_over(std::span<Player const> players) noexcept override;
+    void on_final_scores(std::span<Player const> players) noexcept override;
+
+private:
+    /**
+     * @brief Returns the seat of a player of the current game.
+     */
+    std::uint8_t seat_of(Player const& player) const noexcept;
+
+    /**
+     * @brief Writes a ROUND_WON record for every player whose round went down, then ROUND_END.
+     */
+    void record_round_end(std::span<Player const> players) noexcept;
+
+    LogWriter& writer;
+    Player const* first_seat = nullptr;
+    std::array<short, Config::MAX_PLAYER_COUNT> rounds {};
+};
+
+
+/**
+ * @brief A log file mapped read-only into memory. Logs are read front to back exactly once.
+ */
+class MappedLog {
+public:
+    /**
+     * @brief Maps the log file at path and checks its header.
+     * @throws std::runtime_error if the file cannot be mapped or is not a game log.
+     */
+    explicit MappedLog(std::string const& path);
+
+    /**
+     * @brief Returns the records of the log, without the header.
+     */
+    std::span<std::uint8_t const> records() const noexcept;
+
+private:
+    MappedFile file;
+};
+
+
+/**
+ * @brief Decodes records one by one from a span of log bytes.
+ */
+class LogCursor {
+public:
+    explicit LogCursor(std::span<std::uint8_t const> bytes_in) noexcept
+        : bytes(bytes_in) {}
+
+    /**
+     * @brief Decodes the next record.
+     * @param record Receives the record.
+     * @return False at the end of the log or if the remaining bytes are not a complete record.
+     */
+    bool next(LogRecord& record) noexcept {
+        if (position >= bytes.size() || bytes[position] >= static_cast<std::uint8_t>(LogEvent::COUNT)) {
+            return false;
+        }
+        record.event = static_cast<LogEvent>(bytes[position]);
+        std::size_t const size = record_size(record.event);
+        if (position + 1 + size > bytes.size()) {
+            return false;
+        }
+        record.a = size > 0 ? bytes[position + 1] : 0;
+        record.b = size > 1 ? bytes[position + 2] : 0;
+        record.payload = bytes.subspan(position + 1, size);
+        position += 1 + size;
+        return true;
+    }
+
+    /**
+     * @brief Returns the offset of the next record.
+     */
+    std::size_t offset() const noexcept { return position; }
+
+private:
+    std::span<std::uint8_t const> bytes;
+    std::size_t position = 0;
+};
+
+
+/**
+ * @brief A recorded game located in a log.
+ */
+struct RecordedGame {
+    short num_players = 0;
+    short starting_round = 0;
+    short num_decks = 1;
+
+    /**
+     * @brief The records of the game, from its GAME_SETUP record to its GAME_END record.
+     */
+    std::span<std::uint8_t const> records;
+
+    /**
+     * @brief Every card the deck dealt, in order: the deals, the first discard and the draws.
+     */
+    std::vector<Card> deck_order;
+
+    /**
+     * @brief The strategy of every seat, greedy unless the game has a STRATEGY record for it.
+     */
+    std::vector<Strategy> strategies;
+
+    /**
+     * @brief The choices made by seats with an ExternalStrategy, in the order they were made: true where the discard
+     * was taken. Nothing in the engine can make them again, so replaying a game answers them from here.
+     */
+    std::vector<bool> external_decisions;
+};
+
+/**
+ * @brief Finds a game in a log.
+ * @param records The records of a log.
+ * @param index Zero-based index of the game.
+ * @param game Receives the game.
+ * @return False if the log holds fewer games.
+ * @throws std::runtime_error if the game's player count, starting round or number of decks is out of range, or if it
+ * has a strategy for a seat it does not have or of an unknown kind.
+ */
+bool find_recorded_game(std::span<std::uint8_t const> records, std::size_t index, RecordedGame& game);
@@ -0,0 +1,96 @@
+/**
+ * @file GameServer.h
+ * @brief A server that hosts games for bots in other processes over a Unix domain socket.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Describes a game server.
+ */
+struct ServerConfig {
+    /**
+     * @brief Path of the Unix domain socket to listen on. A stale socket file at the path is replaced.
+     */
+    std::string socket_path;
+
+    /**
+     * @brief Number of event loop threads. 0 uses one per hardware core.
+     */
+    unsigned num_threads = 1;
+
+    /**
+     * @brief Most sessions open at once over all threads; further connections get Protocol::Error::SERVER_FULL.
+     */
+    std::uint32_t max_sessions = 65536;
+};
+
+/**
+ * @brief Counts of what a server has done so far.
+ */
+struct ServerStats {
+    std::uint64_t sessions_opened = 0;
+    std::uint64_t sessions_open = 0;
+    std::uint64_t games_started = 0;
+    std::uint64_t games_finished = 0;
+    std::uint64_t decisions = 0;
+};
+
+/**
+ * @brief Hosts games for bots over a Unix domain socket, speaking the protocol of Protocol.h.
+ *
+ * Every connection is a session in which the client plays seat 0 of one game at a time and the server's greedy
+ * players fill the other seats. Each event loop thread owns an epoll instance and the sessions it accepts; a session
+ * is a Game stepped with Game::steps(), which pauses at the client's turns, and fixed-size input and output buffers,
+ * so it takes a few kilobytes however long it lives and idle sessions cost no thread.
+ */
+class GameServer {
+public:
+    /**
+     * @brief Creates the socket and starts listening on it.
+     * @throws std::runtime_error if the socket cannot be set up.
+     */
+    explicit GameServer(ServerConfig config_in);
+
+    GameServer(GameServer const&) = delete;
+    GameServer& operator=(GameServer const&) = delete;
+
+    /**
+     * @brief Closes every session and removes the socket file.
+     */
+    ~GameServer() noexcept;
+
+    /**
+     * @brief Serves sessions on the event loop threads until stop() is called.
+     * @throws std::runtime_error if an event loop cannot be set up.
+     */
+    void run();
+
+    /**
+     * @brief Makes run() return. Safe to call from another thread or a signal handler.
+     */
+    void stop() noexcept;
+
+    ServerStats get_stats() const noexcept;
+
+private:
+    friend class EventLoop;
+
+    ServerConfig config;
+    int listen_fd = -1;
+
+    /**
+     * @brief Readable once stop() has been called; every event loop watches it.
+     */
+    int stop_fd = -1;
+
+    std::atomic<std::uint64_t> sessions_opened { 0 };
+    std::atomic<std::uint64_t> sessions_open { 0 };
+    std::atomic<std::uint64_t> games_started { 0 };
+    std::atomic<std::uint64_t> games_finished { 0 };
+    std::atomic<std::uint64_t> decisions { 0 };
+};
@@ -0,0 +1,91 @@
+/**
+ * @file GameSnapshot.h
+ * @brief A flat, trivially copyable copy of the state of a Game, and its binary file format.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "CardTracker.h"
+#include "Deck.h"
+#include "Hand.h"
+#include "const.h"
+
+/**
+ * @brief Everything a Game needs to carry on from a point between two turns: the deck, the card tracker, every hand,
+ * every player's round, how many decisions each search strategy has made and how far the round in progress has got.
+ *
+ * The snapshot holds no pointers and sits in fixed arrays sized for the largest table, so saving and restoring are
+ * straight copies and a snapshot can be copied with memcpy, kept in a vector or written to a file as it is. Player
+ * names and strategies are part of how the Game was set up rather than of its state, and are not included.
+ */
+struct GameSnapshot {
+    Deck::Snapshot deck;
+    CardTracker::Snapshot tracker;
+    std::array<Hand, Config::MAX_PLAYER_COUNT> hands;
+    std::array<short, Config::MAX_PLAYER_COUNT> rounds;
+
+    /**
+     * @brief SearchStrategy::get_decisions of each seat, 0 for seats with another strategy.
+     */
+    std::array<std::uint64_t, Config::MAX_PLAYER_COUNT> search_decisions;
+    short num_players;
+    short starting_round;
+    bool shuffle_enabled;
+
+    /**
+     * @brief The round in progress: turns played, face-up cards at the last reshuffle and reshuffles since one was
+     * placed, the seat to play, the seats that completed their hand (bit i for seat i), and whether that seat's turn
+     * has begun and waits for its decision.
+     */
+    std::uint64_t round_turns;
+    std::uint16_t face_up;
+    short idle_reshuffles;
+    std::uint8_t seat;
+    std::uint32_t completed;
+    bool turn_begun;
+};
+
+static_assert(Config::MAX_PLAYER_COUNT <= 32, "GameSnapshot::completed holds one bit per seat");
+static_assert(std::is_trivially_copyable_v<GameSnapshot>, "A GameSnapshot is saved and restored with plain copies");
+
+/**
+ * @brief Magic bytes and format version at the start of every snapshot file.
+ *
+ * The header is the magic, the version, the size of GameSnapshot as a 32-bit number and padding up to
+ * SNAPSHOT_HEADER_SIZE bytes. The bytes of the snapshot in native byte order follow, so a file is only read back by a
+ * build with the same layout.
+ */
+inline constexpr std::array<char, 7> SNAPSHOT_MAGIC = { 'G', 'A', 'R', 'B', 'S', 'N', 'P' };
+inline constexpr std::uint8_t SNAPSHOT_VERSION = 3;
+inline constexpr std::size_t SNAPSHOT_HEADER_SIZE = 16;
+
+/**
+ * @brief Returns the header followed by the bytes of the snapshot.
+ */
+std::vector<std::uint8_t> serialize_snapshot(GameSnapshot const& snapshot);
+
+/**
+ * @brief Reads a snapshot back from the bytes returned by serialize_snapshot.
+ * @throws std::runtime_error if the bytes are not a snapshot of this version and layout, or describe an impossible
+ * state.
+ */
+GameSnapshot deserialize_snapshot(std::span<std::uint8_t const> bytes);
+
+/**
+ * @brief Writes a snapshot to a file, replacing it.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void write_snapshot(std::string const& path, GameSnapshot const& snapshot);
+
+/**
+ * @brief Reads a snapshot from a file written by write_snapshot.
+ * @throws std::runtime_error if the file cannot be read or is not a valid snapshot.
+ */
+GameSnapshot read_snapshot(std::string const& path);
@@ -5,22 +5,34 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <format>
-#include <vector>
+#include <span>
+#include <string_view>
+#include <type_traits>
 
 #include "Card.h"
+#include "EventSink.h"
+#include "Metrics.h"
+#include "const.h"
 
+/**
+ * @brief A player's hand, stored inline: the cards in a fixed array sized for the largest round, and the face-up
+ * state as one bit per position.
+ */
 class Hand {
 public:
     /**
      * @brief Default constructor for Hand.
      */
-    Hand() noexcept;
+    Hand() noexcept = default;
 
     /**
-     * @brief Destructor for Hand.
+     * @brief Destructor for Hand. Defaulted here so a Hand stays trivially copyable.
      */
-    ~Hand() noexcept;
+    ~Hand() noexcept = default;
 
     /**
      * @brief Add a card to the hand (face down by default).
@@ -53,6 +65,12 @@ public:
      */
     bool is_completed() const noexcept;
 
+    /**
+     * @brief Count the cards that are face up.
+     * @return The number of face up cards.
+     */
+    size_t count_showing() const noexcept;
+
     /**
      * @brief Get the card at the given index.
      * @param index The index of the card.
@@ -62,15 +80,21 @@ public:
 
     /**
      * @brief Get all cards in the hand.
-     * @return const reference to the vector of cards.
+     * @return View of the cards in the hand.
      */
-    std::vector<Card> const& get_cards() const noexcept;
+    std::span<Card const> get_cards() const noexcept;
 
     /**
-     * @brief Get all showing flags in the hand.
-     * @return const reference to the vector of showing flags.
+     * @brief Get the showing flags of the hand.
+     * @return Bit i is set if the card at index i is face up.
      */
-    std::vector<bool> const& get_showing() const noexcept;
+    std::uint16_t get_showing_mask() const noexcept;
+
+    /**
+     * @brief Get the number of cards in the hand.
+     * @return The number of cards.
+     */
+    size_t size() const noexcept;
 
     /**
      * @brief Tests if a card is playable.
@@ -79,28 +103,146 @@ public:
      */
     bool card_is_playable(Card const& card) const noexcept;
 
+    /**
+     * @brief Tests if a card is playable in a hand known to hold N cards.
+     */
+    template <std::size_t N>
+    bool card_is_playable(Card const& card) const noexcept;
+
     /** @brief Executes a single play action with the given card.
      * @param card The card to play.
+     * @param sink Receives every placement made while resolving the chain.
      * @return The card that was discarded after playing.
      */
-    Card play_card(Card const& card) noexcept;
+    Card play_card(Card const& card, EventSink& sink) noexcept;
+
+    /**
+     * @brief play_card for a hand known to hold N cards: the chain tests every card against a mask fixed at compile
+     * time instead of one derived from the size.
+     */
+    template <std::size_t N>
+    Card play_card(Card const& card, EventSink& sink) noexcept;
 
 private:
-    std::vector<Card> cards;
-    std::vector<bool> showing;
+    /**
+     * @brief Mask with one bit set for every position in the hand.
+     */
+    std::uint16_t full_mask() const noexcept { return static_cast<std::uint16_t>((1u << count) - 1u); }
+
+    /**
+     * @brief Mask with one bit set for every position in a hand of N cards.
+     */
+    template <std::size_t N>
+    using FullMask = std::integral_constant<std::uint16_t, static_cast<std::uint16_t>((1u << N) - 1u)>;
+
+    /**
+     * @brief card_is_playable against the given mask of positions, a FullMask for the sized overloads.
+     */
+    template <typename Mask>
+    bool card_is_playable_within(Card const& card, Mask full) const noexcept;
+
+    /**
+     * @brief play_card against the given mask of positions, a FullMask for the sized overloads.
+     */
+    template <typename Mask>
+    Card play_card_within(Card const& card, EventSink& sink, Mask full) noexcept;
+
+    std::array<Card, Config::MAX_STARTING_ROUND> cards;
+    std::uint8_t count = 0;
+    std::uint16_t showing = 0;
 };
 
+static_assert(Config::MAX_STARTING_ROUND <= 16, "Hand::showing holds one bit per position");
+static_assert(sizeof(Hand) <= 64, "A Hand should fit in one cache line");
+
+template <typename Mask>
+bool Hand::card_is_playable_within(Card const& card, Mask full) const noexcept {
+    // Ranks above the hand size shift past the mask and test as not playable.
+    unsigned const rank = static_cast<unsigned>(card.get_rank());
+    return ((static_cast<unsigned>(full) & ~static_cast<unsigned>(showing)) >> (rank - 1)) & 1u;
+}
+
+template <typename Mask>
+Card Hand::play_card_within(Card const& card, EventSink& sink, Mask full) noexcept {
+    if (!card_is_playable_within(card, full)) {
+        sink.on_card_not_playable(card);
+        Metrics::observe(Metrics::Histogram::CHAIN_LENGTH, 0);
+        return card;
+    }
+
+    // Keep placing the card that was picked up until it cannot be placed
+    Card current = card;
+    std::uint64_t placed = 0;
+    do {
+        size_t const idx = static_cast<size_t>(current.get_rank()) - 1;
+        Card const replaced = cards[idx];
+        cards[idx] = current;
+        showing |= static_cast<std::uint16_t>(1u << idx);
+        sink.on_card_played(current, replaced);
+        current = replaced;
+        ++placed;
+    } while (card_is_playable_within(current, full));
+    Metrics::observe(Metrics::Histogram::CHAIN_LENGTH, placed);
+    return current;
+}
+
+template <std::size_t N>
+bool Hand::card_is_playable(Card const& card) const noexcept {
+    static_assert(N <= Config::MAX_STARTING_ROUND);
+    return card_is_playable_within(card, FullMask<N>());
+}
+
+template <std::size_t N>
+Card Hand::play_card(Card const& card, EventSink& sink) noexcept {
+    static_assert(N <= Config::MAX_STARTING_ROUND);
+    return play_card_within(card, sink, FullMask<N>());
+}
+
+/**
+ * @brief Calls f with std::integral_constant<std::size_t, N>() for N equal to size, through a jump table, so f can use
+ * the Hand operations specialized for hands of that size. Any other size is passed as 0, for which no card is playable.
+ * @return What f returns.
+ */
+template <typename F>
+decltype(auto) with_hand_size(std::size_t size, F&& f) {
+    static_assert(Config::MAX_STARTING_ROUND == 10, "with_hand_size has a case per hand size");
+    switch (size) {
+    case 1: return f(std::integral_constant<std::size_t, 1>());
+    case 2: return f(std::integral_constant<std::size_t, 2>());
+    case 3: return f(std::integral_constant<std::size_t, 3>());
+    case 4: return f(std::integral_constant<std::size_t, 4>());
+    case 5: return f(std::integral_constant<std::size_t, 5>());
+    case 6: return f(std::integral_constant<std::size_t, 6>());
+    case 7: return f(std::integral_constant<std::size_t, 7>());
+    case 8: return f(std::integral_constant<std::size_t, 8>());
+    case 9: return f(std::integral_constant<std::size_t, 9>());
+    case 10: return f(std::integral_constant<std::size_t, 10>());
+    default: return f(std::integral_constant<std::size_t, 0>());
+    }
+}
+
+/**
+ * @brief Writes a hand to the output: each face-up card followed by a space, "XX " for each face-down card. Takes the
+ * same spec as a Card: fill, alignment and width, then "a" for ASCII suits. The text is put together on the stack and
+ * copied out in one piece.
+ */
 template <>
-struct std::formatter<Hand> : std::formatter<std::string> {
-    auto format(Hand const& h, auto& ctx) const noexcept {
-        std::string s;
-        for (size_t i = 0; i < h.get_cards().size(); ++i) {
+struct std::formatter<Hand> : std::formatter<std::string_view> {
+    bool ascii = false;
+
+    constexpr auto parse(auto& ctx) { return parse_suit_style(ctx, *this, ascii); }
+
+    auto format(Hand const& h, auto& ctx) const {
+        std::array<char, Config::MAX_STARTING_ROUND * (std::formatter<Card>::MAX_SIZE + 1)> text;
+        char* out = text.data();
+        for (size_t i = 0; i < h.size(); ++i) {
             if (h.is_showing(i)) {
-                s += std::format("{} ", h.get_card(i));
+                out = std::formatter<Card>::render(h.get_card(i), ascii, out);
+                *out++ = ' ';
             } else {
-                s += "XX ";
+                out = std::ranges::copy(std::string_view("XX "), out).out;
             }
         }
-        return std::formatter<std::string>::format(s, ctx);
+        return std::formatter<std::string_view>::format(std::string_view(text.data(), out), ctx);
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,185 @@
+/**
+ * @file LockstepEngine.h
+ * @brief Declaration of the lockstep engine, which plays many greedy games side by side in SIMD lanes.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "const.h"
+
+/**
+ * @brief Outcome of one game played by the lockstep engine, as a CountingSink would have counted it.
+ */
+struct LockstepGame {
+    /**
+     * @brief Index of the game in its batch; the game's deck is seeded with stream_seed(master_seed, index).
+     */
+    std::uint64_t index = 0;
+    std::uint32_t rounds = 0;
+    std::uint32_t turns = 0;
+    std::uint32_t reshuffles = 0;
+    std::uint32_t stalemates = 0;
+
+    /**
+     * @brief Rounds each seat had left when the game ended; seats at 0 won.
+     */
+    std::array<short, Config::MAX_PLAYER_COUNT> final_rounds {};
+};
+
+/**
+ * @brief Plays games in which every player follows GreedyStrategy, many at a time.
+ *
+ * Each lane holds one game: its deck ring buffer, hands, face-up masks and shuffle generator are stored as
+ * structure-of-arrays, one array element per lane. A step plays one turn in every lane at once. Lanes diverge in
+ * where they are in their games, so placement chains run until no lane can place anymore, with the finished lanes
+ * masked off. Reshuffles, stalemate checks and the end of a round are rare and are handled one lane at a time
+ * between steps; a lane whose game ends immediately starts the next one.
+ *
+ * The turn kernel uses AVX2 when the CPU supports it and a portable scalar loop over the lanes otherwise. Both
+ * reproduce Game exactly: a game played here with index i has the same outcome as a Game of greedy players seeded
+ * with stream_seed(master_seed, i), with shuffling enabled.
+ */
+class LockstepEngine {
+public:
+    enum class Kernel : std::uint8_t { SCALAR, AVX2 };
+
+    /**
+     * @brief Lanes that measured fastest: one AVX2 vector. More lanes only add cache traffic.
+     */
+    static constexpr std::size_t DEFAULT_LANES = 8;
+
+    /**
+     * @brief Returns the fastest kernel the CPU supports.
+     */
+    static Kernel best_kernel() noexcept;
+
+    /**
+     * @param num_players_in Players per game.
+     * @param starting_round_in Starting round of every game.
+     * @param master_seed_in Seed that game seeds are derived from.
+     * @param lanes_in Games played side by side: a multiple of 8 between 8 and 32.
+     * @param kernel_in The turn kernel; falls back to SCALAR if AVX2 is requested but unsupported.
+     * @throws std::invalid_argument if a parameter is out of range or the hands do not fit in a single deck.
+     */
+    LockstepEngine(short num_players_in, short starting_round_in, std::uint64_t master_seed_in,
+                   std::size_t lanes_in = DEFAULT_LANES, Kernel kernel_in = best_kernel());
+
+    Kernel get_kernel() const noexcept { return kernel; }
+
+    /**
+     * @brief Plays games until claim runs out of them.
+     * @param claim Called whenever a lane is free; returns the index of the next game to play, or nothing.
+     * @param finish Called with the outcome of every game, in the order the games end.
+     */
+    template <typename Claim, typename Finish>
+    void run(Claim&& claim, Finish&& finish) {
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            start_next(lane, claim);
+        }
+        while (active_count > 0) {
+            for (std::uint32_t pending = step(); pending != 0; pending &= pending - 1) {
+                std::size_t const lane = static_cast<std::size_t>(std::countr_zero(pending));
+                if (!settle(lane)) {
+                    finish(result(lane));
+                    start_next(lane, claim);
+                }
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Positions reserved per hand in the hand arrays.
+     */
+    static constexpr int HAND_SLOTS = 16;
+    static constexpr int DECK_SIZE = 52;
+
+    template <typename Claim>
+    void start_next(std::size_t lane, Claim& claim) {
+        std::optional<std::uint64_t> const index = claim();
+        if (index) {
+            start_game(lane, *index);
+        } else if (active[lane] != 0) {
+            active[lane] = 0;
+            --active_count;
+        }
+    }
+
+    /**
+     * @brief Plays one turn in every active lane.
+     * @return Bit i is set if lane i needs settle() before its next turn.
+     */
+    std::uint32_t step() noexcept;
+    std::uint32_t step_scalar() noexcept;
+    std::uint32_t step_avx2() noexcept;
+
+    /**
+     * @brief Plays one turn in one lane. The scalar kernel, and the reference for the AVX2 kernel.
+     * @return True if the lane needs settle() before its next turn.
+     */
+    bool turn(std::size_t lane) noexcept;
+
+    /**
+     * @brief Ends the round or reshuffles the deck of a lane, as Game does between turns.
+     * @return False if the lane's game is over.
+     */
+    bool settle(std::size_t lane) noexcept;
+
+    void start_game(std::size_t lane, std::uint64_t index) noexcept;
+    void start_round(std::size_t lane) noexcept;
+    int deal_one(std::size_t lane) noexcept;
+    int count_face_up(std::size_t lane) const noexcept;
+    LockstepGame result(std::size_t lane) const noexcept;
+
+    int& card(int slot, std::size_t lane) noexcept { return cards[static_cast<std::size_t>(slot) * lanes + lane]; }
+    int& hand(int seat, int position, std::size_t lane) noexcept {
+        return hands[static_cast<std::size_t>(seat * HAND_SLOTS + position) * lanes + lane];
+    }
+    std::size_t seat_index(int seat, std::size_t lane) const noexcept {
+        return static_cast<std::size_t>(seat) * lanes + lane;
+    }
+    static int wrap(int position) noexcept {
+        return position < 0 ? position + DECK_SIZE : position >= DECK_SIZE ? position - DECK_SIZE : position;
+    }
+
+    short num_players;
+    short starting_round;
+    std::uint64_t master_seed;
+    std::size_t lanes;
+    Kernel kernel;
+    std::size_t active_count = 0;
+
+    // Per lane, indexed [slot][lane]: the deck's ring buffer, as Card::get_bits() values
+    std::vector<int> cards;
+    // Per lane, indexed [seat][position][lane]
+    std::vector<int> hands;
+    // Per lane, indexed [seat][lane]
+    std::vector<int> showing;
+    std::vector<int> hand_size;
+    std::vector<int> rounds_left;
+
+    // Per lane
+    std::vector<int> active;
+    std::vector<int> draw_begin;
+    std::vector<int> draw_count;
+    std::vector<int> discard_count;
+    std::vector<int> unshuffled_count;
+    std::vector<int> seat;
+    std::vector<int> won;
+    std::vector<int> face_up;
+    std::vector<int> idle_reshuffles;
+    std::vector<int> turns;
+    std::vector<int> rounds;
+    std::vector<int> reshuffles;
+    std::vector<int> stalemates;
+    std::vector<std::uint64_t> game_index;
+
+    // The shuffle generator of each lane, one array per state word
+    std::array<std::vector<std::uint64_t>, 4> rng_state;
+};
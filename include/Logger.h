@@ -0,0 +1,188 @@
+/**
+ * @file Logger.h
+ * @brief Asynchronous buffered text output: game threads append to their own ring buffers and a background thread
+ * writes the text out in large batches.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Writes text to a file from a background thread.
+ *
+ * Every thread that logs gets its own single-producer ring buffer, so appending takes no lock and makes no system
+ * call: the text is formatted into a reused thread-local buffer and copied into the ring. The writer thread drains
+ * all rings into one batch and writes it with a single call, when a ring fills past half, when flush() is called,
+ * and otherwise every millisecond. A thread only waits when its own ring is full.
+ *
+ * The text of each thread comes out in the order it was logged; text from different threads is interleaved at
+ * message boundaries, except for single messages larger than the ring.
+ */
+class Logger {
+public:
+    enum class Level : std::uint8_t { DEBUG, INFO, WARNING, ERROR, OFF };
+
+    /**
+     * @brief Default size of each thread's ring buffer, in bytes.
+     */
+    static constexpr std::size_t DEFAULT_RING_BYTES = 1 << 20;
+
+    /**
+     * @brief Logs to an open file, which the caller keeps open until the logger is destroyed.
+     * @param out The file to write to, such as stdout.
+     * @param threshold Messages below this level are dropped.
+     * @param ring_bytes Size of each thread's ring buffer, rounded up to a power of two.
+     */
+    explicit Logger(std::FILE* out, Level threshold = Level::INFO, std::size_t ring_bytes = DEFAULT_RING_BYTES);
+
+    /**
+     * @brief Logs to a file, which is created or truncated.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit Logger(std::string const& path, Level threshold = Level::INFO,
+                    std::size_t ring_bytes = DEFAULT_RING_BYTES);
+
+    Logger(Logger const&) = delete;
+    Logger& operator=(Logger const&) = delete;
+
+    /**
+     * @brief Writes out everything logged so far and stops the writer thread.
+     */
+    ~Logger();
+
+    /**
+     * @brief Returns true if messages of the level are written. Check it before building expensive messages.
+     */
+    bool enabled(Level level) const noexcept { return level >= threshold.load(std::memory_order_relaxed); }
+
+    void set_level(Level level) noexcept { threshold.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Formats a message and appends it as one line. A message that cannot be formatted or buffered for lack of
+     * memory is dropped and sets failed().
+     */
+    template <typename... Args>
+    void log(Level level, std::format_string<Args...> format, Args&&... args) noexcept {
+        if (!enabled(level)) {
+            return;
+        }
+        try {
+            std::string& text = scratch();
+            text.clear();
+            std::format_to(std::back_inserter(text), format, std::forward<Args>(args)...);
+            text += '\n';
+            append(text);
+        } catch (std::bad_alloc const&) {
+            write_failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Appends text as it is, without adding a newline.
+     */
+    void write(Level level, std::string_view text) noexcept {
+        if (enabled(level)) {
+            append(text);
+        }
+    }
+
+    /**
+     * @brief Blocks until everything logged by any thread before the call has been written and flushed to the file.
+     */
+    void flush();
+
+    /**
+     * @brief Returns true if some text was lost: a write to the file failed, or a message was dropped for lack of
+     * memory. Call flush() first to catch failures of the text logged so far.
+     */
+    bool failed() const noexcept { return write_failed.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parses a level name: "debug", "info", "warning", "error" or "off".
+     * @return The level, or nothing if the name is not recognized.
+     */
+    static std::optional<Level> level_from_name(std::string_view name) noexcept;
+
+    /**
+     * @brief Creates the logger configured by the environment: GARBAGE_LOG_LEVEL names the level (fallback if
+     * unset) and GARBAGE_LOG_FILE names a file to write to instead of stdout.
+     * @throws std::invalid_argument if the level is not recognized.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    static std::unique_ptr<Logger> from_environment(Level fallback);
+
+private:
+    struct Ring;
+
+    /**
+     * @brief Returns the buffer the calling thread formats its messages into.
+     */
+    static std::string& scratch() noexcept;
+
+    /**
+     * @brief Copies text into the calling thread's ring. If the ring cannot be created, the text is dropped and
+     * failed() is set.
+     */
+    void append(std::string_view text) noexcept;
+
+    /**
+     * @brief Returns the ring of the calling thread, creating it on its first message.
+     */
+    Ring& local_ring();
+
+    void run_writer();
+
+    /**
+     * @brief Moves everything in the rings to the file with a single write. If the batch cannot grow, the text
+     * of that ring is dropped and failed() is set.
+     * @return True if anything was written.
+     */
+    bool drain(std::span<Ring* const> snapshot);
+
+    /**
+     * @brief Wakes the writer thread early.
+     */
+    void wake() noexcept;
+
+    std::FILE* out;
+    bool owns_file = false;
+    std::atomic<Level> threshold;
+    std::size_t ring_bytes;
+
+    /**
+     * @brief Distinguishes this logger from earlier ones at the same address in the threads' ring caches.
+     */
+    std::uint64_t id;
+
+    std::mutex mutex;
+    std::condition_variable writer_wakeup;
+    std::condition_variable flushed;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::uint64_t flushes_requested = 0;
+    std::uint64_t flushes_done = 0;
+    bool stopping = false;
+    std::atomic<bool> wakeup_pending { false };
+    std::atomic<bool> write_failed { false };
+
+    /**
+     * @brief Text collected from the rings, written with one call per drain. Only the writer thread uses it.
+     */
+    std::string batch;
+
+    std::jthread writer;
+};
@@ -0,0 +1,46 @@
+/**
+ * @file MappedFile.h
+ * @brief Declaration of MappedFile, a file mapped read-only into memory.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief A whole file mapped read-only into memory for as long as the object lives.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief How the mapping will be read, passed on to the kernel as a paging hint.
+     */
+    enum class Access : std::uint8_t { SEQUENTIAL, RANDOM };
+
+    /**
+     * @brief Maps the file at path.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    MappedFile(std::string const& path, Access access);
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile() noexcept;
+
+    /**
+     * @brief Returns the contents of the file.
+     */
+    std::span<std::uint8_t const> bytes() const noexcept {
+        return { static_cast<std::uint8_t const*>(address), length };
+    }
+
+private:
+    void* address = nullptr;
+    std::size_t length = 0;
+};
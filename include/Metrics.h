@@ -0,0 +1,181 @@
+/**
+ * @file Metrics.h
+ * @brief Runtime counters and histograms for the engine, compiled out unless GARBAGE_METRICS is defined.
+ *
+ * Hand and Deck count every operation, including those made by search rollouts; the game-level counters only count
+ * real games.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Metrics {
+
+#ifdef GARBAGE_METRICS
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+enum class Counter : std::uint8_t {
+    ROUNDS,
+    TURNS,
+    DRAWS,
+    DISCARDS_TAKEN,
+    RESHUFFLES,
+    STALEMATES,
+    DEAL_NANOSECONDS,
+    TURN_NANOSECONDS,
+    COUNT
+};
+
+enum class Histogram : std::uint8_t {
+    /**
+     * @brief Turns played in each round.
+     */
+    TURNS_PER_ROUND,
+    /**
+     * @brief Cards placed by each Hand::play_card, 0 if the card could not be placed.
+     */
+    CHAIN_LENGTH,
+    COUNT
+};
+
+inline constexpr std::size_t NUM_COUNTERS = static_cast<std::size_t>(Counter::COUNT);
+inline constexpr std::size_t NUM_HISTOGRAMS = static_cast<std::size_t>(Histogram::COUNT);
+
+/**
+ * @brief Buckets per histogram. Bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i), and the last bucket
+ * also counts everything larger.
+ */
+inline constexpr std::size_t NUM_BUCKETS = 24;
+
+/**
+ * @brief Returns the bucket a value falls into.
+ */
+constexpr std::size_t bucket_of(std::uint64_t value) noexcept {
+    return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(value)), NUM_BUCKETS - 1);
+}
+
+/**
+ * @brief The metrics of one thread. Only the owning thread writes them, so updates are plain relaxed loads and
+ * stores; other threads may read them at any time without locking.
+ */
+struct alignas(64) ThreadMetrics {
+    std::array<std::atomic<std::uint64_t>, NUM_COUNTERS> counters {};
+    std::array<std::array<std::atomic<std::uint64_t>, NUM_BUCKETS>, NUM_HISTOGRAMS> buckets {};
+    std::array<std::atomic<std::uint64_t>, NUM_HISTOGRAMS> sums {};
+
+    /**
+     * @brief The thread registered before this one.
+     */
+    ThreadMetrics* next = nullptr;
+};
+
+/**
+ * @brief Allocates the metrics of the calling thread and links them into the global list. The block is never freed,
+ * so the counts of finished threads stay in the totals.
+ */
+ThreadMetrics& register_thread();
+
+/**
+ * @brief Returns the metrics of the calling thread, registering them on first use.
+ */
+inline ThreadMetrics& local() {
+    thread_local ThreadMetrics& metrics = register_thread();
+    return metrics;
+}
+
+/**
+ * @brief Adds to a value that only the calling thread writes.
+ */
+inline void bump(std::atomic<std::uint64_t>& value, std::uint64_t amount) noexcept {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Adds to a counter.
+ */
+inline void add(Counter counter, std::uint64_t amount = 1) noexcept {
+    if constexpr (ENABLED) {
+        bump(local().counters[static_cast<std::size_t>(counter)], amount);
+    }
+}
+
+/**
+ * @brief Records one value in a histogram.
+ */
+inline void observe(Histogram histogram, std::uint64_t value) noexcept {
+    if constexpr (ENABLED) {
+        ThreadMetrics& metrics = local();
+        std::size_t const index = static_cast<std::size_t>(histogram);
+        bump(metrics.buckets[index][bucket_of(value)], 1);
+        bump(metrics.sums[index], value);
+    }
+}
+
+/**
+ * @brief Adds the wall time of its own lifetime to a counter, in nanoseconds.
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Counter counter_in) noexcept
+        : counter(counter_in) {
+        if constexpr (ENABLED) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    PhaseTimer(PhaseTimer const&) = delete;
+    PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+    ~PhaseTimer() noexcept {
+        if constexpr (ENABLED) {
+            auto const elapsed = std::chrono::steady_clock::now() - start;
+            add(counter, static_cast<std::uint64_t>(std::chrono::nanoseconds(elapsed).count()));
+        }
+    }
+
+private:
+    Counter counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Totals over all threads at one point in time.
+ */
+struct Snapshot {
+    std::array<std::uint64_t, NUM_COUNTERS> counters {};
+    std::array<std::array<std::uint64_t, NUM_BUCKETS>, NUM_HISTOGRAMS> buckets {};
+    std::array<std::uint64_t, NUM_HISTOGRAMS> sums {};
+};
+
+/**
+ * @brief Sums the metrics of every thread that has recorded any.
+ */
+Snapshot collect() noexcept;
+
+/**
+ * @brief Formats a snapshot as a JSON object.
+ */
+std::string to_json(Snapshot const& snapshot);
+
+/**
+ * @brief Formats a snapshot in the Prometheus text exposition format.
+ */
+std::string to_prometheus(Snapshot const& snapshot);
+
+/**
+ * @brief If metrics are enabled and the GARBAGE_METRICS_OUT environment variable names a file, writes the current
+ * totals to it: as JSON if the name ends in ".json", otherwise in the Prometheus text format.
+ */
+void dump_if_requested();
+
+}
@@ -0,0 +1,117 @@
+/**
+ * @file Oracle.h
+ * @brief Precomputed expected number of turns to complete a hand, solved offline and memory-mapped at run time.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Hand.h"
+#include "MappedFile.h"
+#include "const.h"
+
+/**
+ * @brief Magic bytes and format version at the start of every oracle file.
+ *
+ * The header is the magic, the version, the largest hand size and padding up to ORACLE_HEADER_SIZE bytes. The table
+ * of doubles in native byte order follows; see oracle_index for its layout.
+ */
+inline constexpr std::array<char, 7> ORACLE_MAGIC = { 'G', 'A', 'R', 'B', 'O', 'R', 'C' };
+inline constexpr std::uint8_t ORACLE_VERSION = 1;
+inline constexpr std::size_t ORACLE_HEADER_SIZE = 16;
+
+/**
+ * @brief Returns the position of a hand state in the oracle table.
+ *
+ * The table holds, for every hand size n from 1 up, one entry per face-up mask of n bits, so the entries of size n
+ * start at 2 + 4 + ... + 2^(n-1) = 2^n - 2.
+ *
+ * @param hand_size Number of cards in the hand, at least 1.
+ * @param showing_mask Bit i is set if the card at position i is face up.
+ */
+constexpr std::size_t oracle_index(std::size_t hand_size, std::uint16_t showing_mask) noexcept {
+    return (std::size_t { 1 } << hand_size) - 2 + showing_mask;
+}
+
+/**
+ * @brief Number of entries in a table covering hand sizes 1 to max_hand_size.
+ */
+constexpr std::size_t oracle_entries(std::size_t max_hand_size) noexcept {
+    return oracle_index(max_hand_size + 1, 0);
+}
+
+/**
+ * @brief Solves the expected number of turns a player needs to complete their hand, for every hand size up to
+ * max_hand_size and every set of face-up positions.
+ *
+ * The model is a player alone with a fresh deck: every card drawn, and every face-down card revealed by a placement,
+ * has each rank with probability 1/13. A turn draws one card and resolves the whole chain of placements it starts.
+ * With that composition the hand state is just its face-up mask, and each placement only adds face-up positions, so
+ * the table is solved exactly by a single pass over the masks from full to empty. Real draws come without
+ * replacement from a finite pile, so real hands finish somewhat sooner; the table is meant for comparing states.
+ *
+ * @param max_hand_size Largest hand size to solve, at most Config::MAX_STARTING_ROUND.
+ * @return The table, laid out as described by oracle_index.
+ */
+std::vector<double> solve_expected_turns(std::size_t max_hand_size);
+
+/**
+ * @brief Writes a solved table to an oracle file.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void write_oracle(std::string const& path, std::span<double const> table, std::size_t max_hand_size);
+
+
+/**
+ * @brief An oracle file mapped read-only into memory, answering expected-turns queries with one load each.
+ */
+class ExpectedTurnsOracle {
+public:
+    /**
+     * @brief Maps the oracle file at path and checks its header and size.
+     * @throws std::runtime_error if the file cannot be mapped or is not an oracle of the current version.
+     */
+    explicit ExpectedTurnsOracle(std::string const& path);
+
+    /**
+     * @brief Returns the largest hand size in the table.
+     */
+    std::size_t max_hand_size() const noexcept { return max_size; }
+
+    /**
+     * @brief Returns the expected number of turns to complete a hand of the given size and face-up mask. An empty hand
+     * is complete and needs none.
+     * @param hand_size Number of cards in the hand, at most max_hand_size().
+     * @param showing_mask Bit i is set if the card at position i is face up, for positions below hand_size only.
+     * @throws std::out_of_range if the hand is larger than the table or the mask has positions beyond the hand.
+     */
+    double expected_turns(std::size_t hand_size, std::uint16_t showing_mask) const {
+        if (hand_size > max_size || (showing_mask >> hand_size) != 0) {
+            reject(hand_size, showing_mask);
+        }
+        return hand_size == 0 ? 0.0 : table[oracle_index(hand_size, showing_mask)];
+    }
+
+    /**
+     * @brief Returns the expected number of turns to complete the hand.
+     * @throws std::out_of_range if the hand is larger than the table.
+     */
+    double expected_turns(Hand const& hand) const {
+        return expected_turns(hand.size(), hand.get_showing_mask());
+    }
+
+private:
+    /**
+     * @brief Throws the std::out_of_range for a query outside the table.
+     */
+    [[noreturn]] void reject(std::size_t hand_size, std::uint16_t showing_mask) const;
+
+    MappedFile file;
+    std::span<double const> table;
+    std::size_t max_size = 0;
+};
@@ -6,120 +6,171 @@
 #pragma once
 
 #include <format>
-#include <optional>
-#include <print>
+#include <span>
 #include <string>
-#include <vector>
+#include <variant>
 
 #include "Card.h"
+#include "CardTracker.h"
 #include "Deck.h"
+#include "EventSink.h"
 #include "Hand.h"
+#include "Metrics.h"
+#include "Strategy.h"
 
 /**
  * @brief Represents a player in the game.
+ *
+ * A Player is a plain value: its decisions come from the Strategy it holds, so players can be stored contiguously and
+ * copied freely.
  */
 class Player {
 public:
-    Player(std::string const name_in, short const round_in) noexcept
+    Player(std::string const name_in, short const round_in, Strategy strategy_in = GreedyStrategy {}) noexcept
         : round(round_in)
-        , name(name_in) {}
+        , name(name_in)
+        , strategy(strategy_in) {}
 
     /**
      * @brief Returns player's name.
      */
-    virtual std::string const& get_name() const noexcept = 0;
+    std::string const& get_name() const noexcept { return name; }
 
     /**
      * @brief Returns player's current round.
      */
-    virtual short const& get_round() const noexcept = 0;
+    short const& get_round() const noexcept { return round; }
+
+    /**
+     * @brief Returns player's hand.
+     */
+    Hand const& get_hand() const noexcept { return hand; }
+
+    /**
+     * @brief Returns player's strategy.
+     */
+    Strategy const& get_strategy() const noexcept { return strategy; }
 
     /**
      * @brief Adds Card to Player's hand.
      */
-    virtual void add_card(Card const& c) noexcept = 0;
+    void add_card(Card const& c) noexcept { hand.add_card(c); }
 
     /**
      * @brief Resets the player's hand.
      */
-    virtual void reset_hand() noexcept = 0;
+    void reset_hand() noexcept { hand.reset(); }
 
     /**
      * @brief Plays a turn according to their strategy. The card is removed from the player's hand
      * and discarded.
      * @param deck The deck from which to draw a card if needed.
+     * @param players All players in seat order; this player must be one of them.
+     * @param tracker The unseen cards of the current round.
+     * @param sink Receives the events of this turn.
      * @return true if the player completed their round in this turn. Otherwise false.
      */
-    virtual bool take_turn(Deck& deck) noexcept = 0;
+    bool take_turn(Deck& deck, std::span<Player const> players, CardTracker const& tracker, EventSink& sink) noexcept {
+        sink.on_turn_state(*this, hand, deck.peek_discard());
+        return play_turn(wants_discard(deck, players, tracker), deck, sink);
+    }
+
+    /**
+     * @brief Asks the player's strategy whether to take the top discard rather than draw.
+     * @param deck The deck of the game.
+     * @param players All players in seat order; this player must be one of them.
+     * @param tracker The unseen cards of the current round.
+     */
+    bool wants_discard(Deck const& deck, std::span<Player const> players, CardTracker const& tracker) const {
+        TurnView const view { hand, deck.peek_discard(), deck, tracker, players,
+                              static_cast<std::size_t>(this - players.data()) };
+        return std::visit([&](auto const& s) { return s.take_discard(view); }, strategy);
+    }
 
     /**
-     * @brief Decreases the player's round by 1 upon winning a round.
+     * @brief Plays a turn with the given decision: takes the discard or draws, places the card and discards the card
+     * it frees.
+     * @return true if the player completed their round in this turn. Otherwise false.
+     */
+    bool play_turn(bool take_discard, Deck& deck, EventSink& sink) noexcept {
+        Card card_to_play;
+        if (take_discard) {
+            card_to_play = deck.take_discard();
+            sink.on_take_discard(*this, card_to_play);
+            Metrics::add(Metrics::Counter::DISCARDS_TAKEN);
+        } else {
+            card_to_play = deck.deal_one();
+            sink.on_draw(*this, card_to_play);
+            Metrics::add(Metrics::Counter::DRAWS);
+        }
+        Card flipped_card = hand.play_card(card_to_play, sink);
+        sink.on_discard(*this, flipped_card);
+        deck.discard(flipped_card);
+        return hand.is_completed();
+    }
+
+    /**
+     * @brief Puts the player back at the start of a game from the given round, with an empty hand.
+     */
+    void reset(short round_in) noexcept {
+        round = round_in;
+        hand.reset();
+    }
+
+    /**
+     * @brief Replaces the player's strategy.
      */
-    virtual void register_win() noexcept = 0;
+    void set_strategy(Strategy strategy_in) noexcept { strategy = strategy_in; }
 
     /**
-     * @brief Virtual destructor for Player.
+     * @brief Puts the player back in a saved position: their round and their hand.
      */
-    virtual ~Player() noexcept {}
+    void restore(short round_in, Hand const& hand_in) noexcept {
+        round = round_in;
+        hand = hand_in;
+    }
+
+    /**
+     * @brief Decreases the player's round by 1 upon winning a round.
+     */
+    void register_win() noexcept {
+        if (round > 0) [[likely]] {
+            --round;
+        }
+    }
 
-protected:
+private:
     short round;
     std::string name;
     Hand hand;
+    Strategy strategy;
 };
 
 
 /**
- * @brief Returns a pointer to a player with the given name and round.
+ * @brief Returns a player with the given name, round and strategy.
  */
-Player* Player_factory(std::string const name, short const round);
+Player Player_factory(std::string const name, short const round, Strategy strategy = GreedyStrategy {});
 
 
 /**
- * @brief A computer player implementation of the Player interface.
+ * @brief Writes a player's name and round, one per line. Without a spec the text goes straight to the output; a string
+ * spec for fill, alignment and width applies to the whole text.
  */
-class ComputerPlayer : public Player {
-public:
-    ComputerPlayer(std::string const& name_in, short round_in) noexcept
-        : Player(name_in, round_in) {}
-
-    std::string const& get_name() const noexcept override { return name; }
-
-    short const& get_round() const noexcept override { return round; }
-
-    void reset_hand() noexcept override { hand.reset(); }
-
-    void add_card(Card const& c) noexcept override { hand.add_card(c); }
+template <>
+struct std::formatter<Player> : std::formatter<std::string_view> {
+    bool plain = true;
 
-    void register_win() noexcept override {
-        if (round > 0) [[likely]] {
-            --round;
-        }
+    constexpr auto parse(auto& ctx) {
+        plain = ctx.begin() == ctx.end() || *ctx.begin() == '}';
+        return std::formatter<std::string_view>::parse(ctx);
     }
 
-    bool take_turn(Deck& deck) noexcept override {
-        std::println("{}'s turn. Current hand: {}", name, hand);
-        std::println("Top of discard pile: {}", deck.peek_discard());
-
-        Card card_to_play;
-        if (hand.card_is_playable(deck.peek_discard())) {
-            card_to_play = deck.take_discard();
-            std::println("{} takes from discard pile: {}", name, card_to_play);
-        } else {
-            card_to_play = deck.deal_one();
-            std::println("{} draws from deck: {}", name, card_to_play);
+    auto format(Player const& p, auto& ctx) const {
+        if (plain) {
+            return std::format_to(ctx.out(), "{}\nRound: {}\n", p.get_name(), p.get_round());
         }
-        Card flipped_card = hand.play_card(card_to_play);
-        std::println("{} discards: {}", name, flipped_card);
-        deck.discard(flipped_card);
-        return hand.is_completed();
+        std::string const text = std::format("{}\nRound: {}\n", p.get_name(), p.get_round());
+        return std::formatter<std::string_view>::format(text, ctx);
     }
 };
-
-template <>
-struct std::formatter<Player> : std::formatter<std::string> {
-    auto format(Player const& p, auto& ctx) const noexcept {
-        std::string s = p.get_name() + "\nRound: " + std::to_string(p.get_round()) + "\n";
-        return std::formatter<std::string>::format(s, ctx);
-    }
-};
\ No newline at end of file
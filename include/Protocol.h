@@ -0,0 +1,142 @@
+/**
+ * @file Protocol.h
+ * @brief The binary protocol between the game server and the bots that play on it.
+ *
+ * Every message is a frame: a one-byte tag, a one-byte payload length and the payload. Multi-byte numbers are little
+ * endian and cards are sent as Card::get_bits(). A session goes:
+ *
+ *     client: HELLO              server: DECISION, DECISION, ..., GAME_OVER
+ *     client: DECIDE (each DECISION)
+ *
+ * and may then send HELLO again for another game. The server answers any message it cannot accept with ERROR and
+ * closes the connection.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "Card.h"
+#include "Hand.h"
+#include "const.h"
+
+namespace Protocol {
+
+inline constexpr std::uint8_t VERSION = 1;
+
+/**
+ * @brief Tag and length bytes in front of every payload.
+ */
+inline constexpr std::size_t HEADER_SIZE = 2;
+
+/**
+ * @brief Largest payload of any message; longer frames are rejected.
+ */
+inline constexpr std::size_t MAX_PAYLOAD = 64;
+inline constexpr std::size_t MAX_FRAME_SIZE = HEADER_SIZE + MAX_PAYLOAD;
+
+enum class Message : std::uint8_t {
+    // Client to server
+    HELLO,     // version, num_players, starting_round, seed (8 bytes): a new game, the client in seat 0
+    DECIDE,    // 1 to take the top discard, 0 to draw
+    // Server to client
+    DECISION,  // round, top discard, showing mask (2 bytes), hand size, cards: the client's turn
+    GAME_OVER, // num_players, rounds left in every seat
+    ERROR,     // error code
+    COUNT
+};
+
+enum class Error : std::uint8_t {
+    /**
+     * @brief The frame has an unknown tag or the wrong length.
+     */
+    BAD_MESSAGE,
+    BAD_VERSION,
+    /**
+     * @brief The table asked for cannot be dealt.
+     */
+    BAD_TABLE,
+    /**
+     * @brief The message does not fit the state of the session, such as DECIDE with no decision pending.
+     */
+    UNEXPECTED,
+    /**
+     * @brief The server already holds as many sessions as it allows.
+     */
+    SERVER_FULL
+};
+
+/**
+ * @brief Asks for a game against the server's own players.
+ */
+struct Hello {
+    std::uint8_t version = VERSION;
+    std::uint8_t num_players = 2;
+    std::uint8_t starting_round = Config::MAX_STARTING_ROUND;
+
+    /**
+     * @brief Seed of the game's deck; 0 lets the server pick one.
+     */
+    std::uint64_t seed = 0;
+};
+
+/**
+ * @brief Everything the client sees at its turn.
+ */
+struct Decision {
+    std::uint8_t round = 0;
+    Card top_discard;
+    Hand hand;
+};
+
+/**
+ * @brief Rounds every seat had left at the end of a game; the seats at 0 won.
+ */
+struct GameOver {
+    std::uint8_t num_players = 0;
+    std::array<std::uint8_t, Config::MAX_PLAYER_COUNT> rounds {};
+};
+
+/**
+ * @brief A whole frame at the start of a buffer.
+ */
+struct Frame {
+    Message message;
+    std::span<std::uint8_t const> payload;
+
+    /**
+     * @brief Bytes the frame takes up, header included.
+     */
+    std::size_t size;
+};
+
+/**
+ * @brief Finds the frame at the start of bytes.
+ * @return The frame, or nothing if bytes does not hold all of it yet.
+ * @throws std::runtime_error if the tag is unknown or the payload longer than MAX_PAYLOAD.
+ */
+std::optional<Frame> parse_frame(std::span<std::uint8_t const> bytes);
+
+/**
+ * @brief Writers put a whole frame at the start of out, which must hold MAX_FRAME_SIZE bytes, and return its size.
+ */
+std::size_t write_hello(std::span<std::uint8_t> out, Hello const& hello) noexcept;
+std::size_t write_decide(std::span<std::uint8_t> out, bool take_discard) noexcept;
+std::size_t write_decision(std::span<std::uint8_t> out, Decision const& decision) noexcept;
+std::size_t write_game_over(std::span<std::uint8_t> out, GameOver const& game_over) noexcept;
+std::size_t write_error(std::span<std::uint8_t> out, Error error) noexcept;
+
+/**
+ * @brief Readers decode the payload of a frame with the matching tag.
+ * @throws std::runtime_error if the payload is malformed.
+ */
+Hello read_hello(Frame const& frame);
+bool read_decide(Frame const& frame);
+Decision read_decision(Frame const& frame);
+GameOver read_game_over(Frame const& frame);
+Error read_error(Frame const& frame);
+
+}
@@ -0,0 +1,130 @@
+/**
+ * @file Random.h
+ * @brief Small, fast, seedable random number generators used for shuffling.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/**
+ * @brief SplitMix64 generator. Mostly used to expand a single seed into the state of another generator.
+ */
+class SplitMix64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit constexpr SplitMix64(std::uint64_t seed) noexcept
+        : state(seed) {}
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() noexcept {
+        state += 0x9E3779B97F4A7C15ull;
+        return mix(state);
+    }
+
+    /**
+     * @brief The SplitMix64 output function: a bijective, well-avalanching 64-bit hash.
+     */
+    static constexpr std::uint64_t mix(std::uint64_t z) noexcept {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::uint64_t state;
+};
+
+
+/**
+ * @brief xoshiro256** generator: 32 bytes of state and a handful of ALU operations per 64-bit output.
+ */
+class Xoshiro256StarStar {
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Seeds the generator by expanding the seed with SplitMix64, as recommended by the authors.
+     */
+    explicit constexpr Xoshiro256StarStar(std::uint64_t seed) noexcept {
+        SplitMix64 expand(seed);
+        for (auto& word : state) {
+            word = expand();
+        }
+    }
+
+    /**
+     * @brief Resumes a generator from a state returned by get_state().
+     */
+    explicit constexpr Xoshiro256StarStar(std::array<std::uint64_t, 4> const& state_in) noexcept
+        : state(state_in) {}
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Returns the full state, for engines that keep many generators in separate arrays.
+     */
+    constexpr std::array<std::uint64_t, 4> const& get_state() const noexcept { return state; }
+
+    constexpr result_type operator()() noexcept {
+        result_type const result = std::rotl(state[1] * 5, 7) * 9;
+        result_type const t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = std::rotl(state[3], 45);
+        return result;
+    }
+
+private:
+    std::array<std::uint64_t, 4> state {};
+};
+
+
+/**
+ * @brief The generator used by Deck. Change this alias to swap the shuffle generator everywhere.
+ */
+using Rng = Xoshiro256StarStar;
+
+static_assert(std::uniform_random_bit_generator<Rng>);
+
+
+/**
+ * @brief Derives the seed of one stream from a master seed and a stream index.
+ *
+ * Used to give game i of a batch its own shuffle stream, so a batch plays out identically no matter how its games are
+ * spread across threads.
+ */
+constexpr std::uint64_t stream_seed(std::uint64_t master_seed, std::uint64_t index) noexcept {
+    return SplitMix64::mix(master_seed ^ SplitMix64::mix(index + 0x9E3779B97F4A7C15ull));
+}
+
+/**
+ * @brief Returns a uniformly distributed integer in [0, bound) using Lemire's multiply-and-reject method.
+ * @param g A generator producing full-range 64-bit values.
+ * @param bound Exclusive upper bound; must be greater than zero.
+ */
+template <std::uniform_random_bit_generator G>
+    requires(G::min() == 0 && G::max() == std::numeric_limits<std::uint64_t>::max())
+constexpr std::uint32_t random_below(G& g, std::uint32_t bound) noexcept {
+    std::uint64_t product = (g() >> 32) * bound;
+    auto low = static_cast<std::uint32_t>(product);
+    if (low < bound) {
+        std::uint32_t const threshold = static_cast<std::uint32_t>(-bound) % bound;
+        while (low < threshold) {
+            product = (g() >> 32) * bound;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
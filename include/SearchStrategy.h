@@ -0,0 +1,59 @@
+/**
+ * @file SearchStrategy.h
+ * @brief Declaration of the information-set Monte Carlo search strategy.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+struct TurnView;
+
+/**
+ * @brief Chooses between taking the discard and drawing by simulating the rest of the round.
+ *
+ * Each iteration samples a determinization: the cards the player has not seen (face-down cards in every hand and the
+ * draw pile) are dealt out at random, consistent with everything that is face up. The discard pile is kept as it is,
+ * since every card in it was seen being discarded. Both actions are then played out from that same determinization, with every player following the greedy rule
+ * afterwards, and the action whose rollouts complete the player's hand more often is chosen.
+ *
+ * Search stops when either budget is used up; a zero budget is unlimited, but at least one must be set. With only a
+ * rollout budget the choice depends only on the seed, however many threads search.
+ */
+struct SearchStrategy {
+    /**
+     * @brief Maximum number of determinizations per decision. Each one is played out once per action.
+     */
+    std::uint32_t rollouts = 1000;
+
+    /**
+     * @brief Maximum wall-clock time per decision.
+     */
+    std::chrono::microseconds time_budget { 0 };
+
+    /**
+     * @brief Number of threads that run rollouts for one decision: the deciding thread and threads - 1 helpers, which
+     * it starts on its first such decision and keeps for the next ones.
+     */
+    unsigned threads = 1;
+
+    /**
+     * @brief Seed of the sampling streams. Decision d of thread t samples from stream_seed(seed, d * threads + t).
+     */
+    std::uint64_t seed = 0;
+
+    bool take_discard(TurnView const& view) const;
+
+    /**
+     * @brief Number of decisions made so far. Saved with a game, so a restored game samples the same streams again.
+     */
+    std::uint64_t get_decisions() const noexcept { return decisions; }
+    void set_decisions(std::uint64_t decisions_in) noexcept { decisions = decisions_in; }
+
+private:
+    /**
+     * @brief Number of decisions made so far, so every decision samples from fresh streams.
+     */
+    mutable std::uint64_t decisions = 0;
+};
@@ -0,0 +1,181 @@
+/**
+ * @file Stats.h
+ * @brief Streaming statistics that take one value at a time in constant memory and merge associatively, so every
+ * worker can summarize its own games and the summaries can be combined in any order at the end.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief A two-sided confidence interval.
+ */
+struct Interval {
+    double low = 0.0;
+    double high = 0.0;
+};
+
+/**
+ * @brief Normal quantile of a two-sided 95% confidence interval.
+ */
+inline constexpr double Z_95 = 1.959963984540054;
+
+/**
+ * @brief Count, mean, variance and range of a stream of values, using Welford's update and Chan's merge.
+ */
+class RunningStats {
+public:
+    /**
+     * @brief Adds one value.
+     */
+    void add(double value) noexcept;
+
+    /**
+     * @brief Adds every value seen by another accumulator, as if they had been added here.
+     */
+    void merge(RunningStats const& other) noexcept;
+
+    std::uint64_t count() const noexcept { return n; }
+    double mean() const noexcept { return n > 0 ? running_mean : 0.0; }
+    double min() const noexcept { return n > 0 ? lowest : 0.0; }
+    double max() const noexcept { return n > 0 ? highest : 0.0; }
+
+    /**
+     * @brief Unbiased sample variance; 0 with fewer than two values.
+     */
+    double variance() const noexcept;
+    double stddev() const noexcept;
+
+    /**
+     * @brief Confidence interval of the mean under the normal approximation.
+     * @param z Normal quantile of the interval, Z_95 for 95%.
+     */
+    Interval mean_interval(double z = Z_95) const noexcept;
+
+private:
+    std::uint64_t n = 0;
+    double running_mean = 0.0;
+    double m2 = 0.0;
+    double lowest = std::numeric_limits<double>::infinity();
+    double highest = -std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Quantiles of a stream of non-negative values with a bounded relative error.
+ *
+ * Meant for counts such as turns per game: zeros are counted exactly, and values from 1 up are counted in
+ * logarithmic buckets whose bounds grow by a factor of (1 + a) / (1 - a), so the midpoint of a bucket is within a
+ * relative error a of every value in it (the DDSketch construction). Buckets are a fixed array, so adding never
+ * allocates and merging is an exact element-wise sum.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @brief Relative error of every quantile.
+     */
+    static constexpr double RELATIVE_ACCURACY = 0.01;
+
+    /**
+     * @brief Number of buckets for positive values: enough for values up to about 7e8, larger ones share the last.
+     */
+    static constexpr std::size_t NUM_BUCKETS = 1024;
+
+    /**
+     * @brief Adds one value; negative values count as zero.
+     */
+    void add(double value) noexcept;
+
+    /**
+     * @brief Adds every value seen by another sketch.
+     */
+    void merge(QuantileSketch const& other) noexcept;
+
+    std::uint64_t count() const noexcept { return total; }
+
+    /**
+     * @brief Returns the q-quantile of the values added, or 0 if there are none.
+     * @param q Between 0 and 1.
+     */
+    double quantile(double q) const noexcept;
+
+private:
+    std::uint64_t total = 0;
+    std::uint64_t zeros = 0;
+    std::array<std::uint64_t, NUM_BUCKETS> buckets {};
+};
+
+/**
+ * @brief Moments and quantiles of one quantity, such as the number of turns a game takes.
+ */
+class Distribution {
+public:
+    void add(double value) noexcept {
+        moments.add(value);
+        sketch.add(value);
+    }
+
+    void merge(Distribution const& other) noexcept {
+        moments.merge(other.moments);
+        sketch.merge(other.sketch);
+    }
+
+    RunningStats const& stats() const noexcept { return moments; }
+    double quantile(double q) const noexcept { return sketch.quantile(q); }
+
+private:
+    RunningStats moments;
+    QuantileSketch sketch;
+};
+
+/**
+ * @brief Wilson score interval of a proportion, which stays inside [0, 1] and behaves well near 0 and 1.
+ * @param successes Number of successes.
+ * @param trials Number of trials; the interval is [0, 1] if there are none.
+ * @param z Normal quantile of the interval, Z_95 for 95%.
+ */
+Interval wilson_interval(std::uint64_t successes, std::uint64_t trials, double z = Z_95) noexcept;
+
+/**
+ * @brief Sequential probability ratio test between two means of a stream of observations, such as the score of a
+ * strategy per pair of games.
+ *
+ * Uses the normal approximation of the generalized SPRT: the observations are taken as normal with the sample
+ * variance seen so far, and the test stops once the log-likelihood ratio of mean mu1 against mean mu0 leaves
+ * [log(beta / (1 - alpha)), log((1 - beta) / alpha)]. The error rates are then about alpha for accepting mu1 when the
+ * mean is mu0 and beta for accepting mu0 when it is mu1, whatever the number of observations.
+ */
+class Sprt {
+public:
+    enum class Decision : std::uint8_t { CONTINUE, ACCEPT_H0, ACCEPT_H1 };
+
+    /**
+     * @param mu0 Mean under the null hypothesis.
+     * @param mu1 Mean under the alternative hypothesis.
+     * @param alpha Probability of accepting H1 when H0 holds.
+     * @param beta Probability of accepting H0 when H1 holds.
+     * @throws std::invalid_argument if the means are equal or an error rate is not strictly between 0 and 1.
+     */
+    Sprt(double mu0, double mu1, double alpha, double beta);
+
+    /**
+     * @brief Log-likelihood ratio of H1 against H0 given the observations summarized in stats.
+     */
+    double llr(RunningStats const& stats) const noexcept;
+
+    /**
+     * @brief Decides from the observations so far; waits for at least two observations.
+     */
+    Decision decide(RunningStats const& stats) const noexcept;
+
+    double lower_bound() const noexcept { return lower; }
+    double upper_bound() const noexcept { return upper; }
+
+private:
+    double mu0;
+    double mu1;
+    double lower;
+    double upper;
+};
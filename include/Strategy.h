@@ -0,0 +1,90 @@
+/**
+ * @file Strategy.h
+ * @brief Decision policies for players and the view of the table they decide from.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+
+#include "Card.h"
+#include "CardTracker.h"
+#include "Deck.h"
+#include "Hand.h"
+#include "SearchStrategy.h"
+
+class Player;
+
+/**
+ * @brief Everything a strategy may look at when making a decision.
+ */
+struct TurnView {
+    /**
+     * @brief Hand of the player to move.
+     */
+    Hand const& hand;
+
+    /**
+     * @brief Top of the discard pile.
+     */
+    Card const& top_discard;
+
+    Deck const& deck;
+
+    /**
+     * @brief Counts of the cards nobody has seen this round.
+     */
+    CardTracker const& tracker;
+
+    /**
+     * @brief All players in seat order, including the one to move.
+     */
+    std::span<Player const> players;
+
+    /**
+     * @brief Seat of the player to move.
+     */
+    std::size_t seat;
+};
+
+/**
+ * @brief Takes the discard whenever it can be placed, otherwise draws.
+ */
+struct GreedyStrategy {
+    bool take_discard(TurnView const& view) const noexcept { return view.hand.card_is_playable(view.top_discard); }
+};
+
+/**
+ * @brief Always draws from the deck. A baseline for comparing other strategies.
+ */
+struct DrawOnlyStrategy {
+    bool take_discard(TurnView const&) const noexcept { return false; }
+};
+
+/**
+ * @brief Leaves every decision to someone outside the engine, such as a bot in another process. Game::steps() pauses
+ * at each turn of the player for the decision to be passed to Game::decide(); where there is nobody to ask, as in
+ * Game::play(), the player draws.
+ */
+struct ExternalStrategy {
+    bool take_discard(TurnView const&) const noexcept { return false; }
+};
+
+/**
+ * @brief Any of the available strategies. Players hold one by value and dispatch on it with std::visit, so every
+ * decision compiles to a switch over the alternatives with the chosen one inlined.
+ *
+ * To add a strategy, define a type with a `bool take_discard(TurnView const&)` member and add it here.
+ */
+using Strategy = std::variant<GreedyStrategy, DrawOnlyStrategy, SearchStrategy, ExternalStrategy>;
+
+/**
+ * @brief Parses a strategy name: "greedy", "draw" or "search[:budget[:threads]]", where the search budget is a
+ * number of rollouts or a time per decision such as "500us" or "2ms".
+ * @return The strategy, or nothing if the name is not recognized.
+ */
+std::optional<Strategy> strategy_from_name(std::string_view name);
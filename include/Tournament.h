@@ -0,0 +1,141 @@
+/**
+ * @file Tournament.h
+ * @brief Tournaments between strategies: match scheduling on a work-stealing pool and incremental Elo ratings.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Strategy.h"
+#include "const.h"
+
+/**
+ * @brief A strategy taking part in a tournament, under the name it is reported with.
+ */
+struct Entrant {
+    std::string name;
+    Strategy strategy;
+};
+
+/**
+ * @brief Elo ratings of a field of entrants, updated one game at a time.
+ *
+ * A game of several players counts as a game between every pair of them: the player who finished with fewer rounds
+ * left scores the pair, equal rounds split it. Each pair moves both ratings by k / (players - 1) times the difference
+ * between the score and the expected score, so a game moves a rating by at most k whatever the table size.
+ */
+class EloRatings {
+public:
+    static constexpr double INITIAL_RATING = 1500.0;
+    static constexpr double DEFAULT_K = 16.0;
+
+    explicit EloRatings(std::size_t num_entrants, double k_in = DEFAULT_K);
+
+    /**
+     * @brief Updates the ratings with the outcome of one game.
+     * @param seats Entrant index of each seat.
+     * @param final_rounds Rounds each seat had left at the end; fewer is better and 0 won.
+     */
+    void record(std::span<std::uint16_t const> seats, std::span<short const> final_rounds) noexcept;
+
+    double rating(std::size_t entrant) const noexcept { return ratings[entrant]; }
+    std::uint64_t games(std::size_t entrant) const noexcept { return games_played[entrant]; }
+    std::uint64_t wins(std::size_t entrant) const noexcept { return games_won[entrant]; }
+    std::size_t size() const noexcept { return ratings.size(); }
+
+    /**
+     * @brief Expected score of a player rated a against one rated b.
+     */
+    static double expected_score(double a, double b) noexcept;
+
+private:
+    double k;
+    std::vector<double> ratings;
+    std::vector<std::uint64_t> games_played;
+    std::vector<std::uint64_t> games_won;
+};
+
+/**
+ * @brief Describes a tournament.
+ */
+struct TournamentConfig {
+    enum class Format : std::uint8_t {
+        /**
+         * @brief Every pair of entrants plays games_per_pairing games from every starting round, alternating seats.
+         */
+        ROUND_ROBIN,
+        /**
+         * @brief num_matches games, each between players_per_match distinct entrants drawn at random, from a starting
+         * round drawn at random from starting_rounds.
+         */
+        RANDOM_PAIRING
+    };
+
+    std::vector<Entrant> entrants;
+    Format format = Format::ROUND_ROBIN;
+
+    /**
+     * @brief Games per pair of entrants and starting round, for ROUND_ROBIN.
+     */
+    std::uint64_t games_per_pairing = 1;
+
+    /**
+     * @brief Number of games, for RANDOM_PAIRING.
+     */
+    std::uint64_t num_matches = 0;
+
+    /**
+     * @brief Seats at every table, for RANDOM_PAIRING; round robins are always played in pairs.
+     */
+    short players_per_match = 2;
+
+    std::vector<short> starting_rounds { Config::MAX_STARTING_ROUND };
+
+    /**
+     * @brief Master seed. Match m deals from stream_seed(seed, m), so the results do not depend on the threads.
+     */
+    std::uint64_t seed = 0;
+
+    /**
+     * @brief Number of worker threads. 0 uses one thread per hardware core.
+     */
+    unsigned num_threads = 0;
+
+    /**
+     * @brief If set, called with the ratings after every progress_interval matches, from the thread that runs the
+     * tournament.
+     */
+    std::function<void(std::uint64_t matches_rated, EloRatings const& ratings)> on_progress;
+    std::uint64_t progress_interval = 0;
+};
+
+/**
+ * @brief Outcome of a tournament.
+ */
+struct TournamentResult {
+    EloRatings ratings;
+    std::uint64_t matches = 0;
+
+    /**
+     * @brief Matches that were stolen by another worker than the one they were dealt to.
+     */
+    std::uint64_t steals = 0;
+};
+
+/**
+ * @brief Plays every match of a tournament and rates the entrants.
+ *
+ * Matches are scheduled with run_work_stealing, longest expected first, so a few long games from round 10 do not
+ * hold up the end of the run. Ratings are updated on the calling thread while the workers play: each finished match
+ * is applied as soon as every match scheduled before it has been, so the ratings follow the games almost as they
+ * finish and still come out the same for every number of threads.
+ *
+ * @throws std::invalid_argument if the tournament cannot be played as described.
+ * @throws Whatever the first failing match threw, once the workers have stopped; the matches left are not played.
+ */
+TournamentResult run_tournament(TournamentConfig const& config);
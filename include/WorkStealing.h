@@ -0,0 +1,88 @@
+/**
+ * @file WorkStealing.h
+ * @brief A pool of worker threads that each run their own queue of tasks and steal from the others when it runs dry.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+
+/**
+ * @brief A Chase-Lev work-stealing deque of task indices with a fixed capacity.
+ *
+ * The owning thread pushes and takes tasks at the bottom; any other thread steals from the top. Only the last task
+ * is contended, and then a single compare-and-swap decides who gets it. The memory orders are those of Le et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models".
+ */
+class TaskDeque {
+public:
+    /**
+     * @brief Creates an empty deque.
+     * @param capacity Most tasks the deque holds at once, rounded up to a power of two.
+     */
+    explicit TaskDeque(std::size_t capacity);
+
+    /**
+     * @brief Adds a task at the bottom. Called by the owner only, and never beyond the capacity.
+     */
+    void push(std::uint32_t task) noexcept;
+
+    /**
+     * @brief Takes the task at the bottom, the one pushed last. Called by the owner only.
+     * @return The task, or nothing if the deque is empty.
+     */
+    std::optional<std::uint32_t> take() noexcept;
+
+    /**
+     * @brief Steals the task at the top, the one pushed first. Called by any thread but the owner.
+     * @param contended Set to true if another thread took the top task first.
+     * @return The task, or nothing if the deque is empty or the steal lost a race.
+     */
+    std::optional<std::uint32_t> steal(bool& contended) noexcept;
+
+private:
+    std::size_t mask;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> tasks;
+
+    /**
+     * @brief Position of the next task to steal. Advanced by thieves, and by the owner when it takes the last task.
+     */
+    alignas(64) std::atomic<std::int64_t> top { 0 };
+
+    /**
+     * @brief Position after the last task. Written by the owner only.
+     */
+    alignas(64) std::atomic<std::int64_t> bottom { 0 };
+};
+
+/**
+ * @brief What a work-stealing run did.
+ */
+struct WorkStealingStats {
+    std::uint64_t tasks_run = 0;
+
+    /**
+     * @brief Tasks that ran on another worker than the one they were dealt to.
+     */
+    std::uint64_t steals = 0;
+};
+
+/**
+ * @brief Runs every task once on a pool of worker threads and returns when all have finished.
+ *
+ * The tasks are dealt round-robin to the workers' deques in the given order, so passing them from the most to the
+ * least expensive gives every worker a similar share of long tasks up front. Each worker runs its own tasks, largest
+ * first, and once it runs dry steals the smallest remaining tasks of other workers, so the run finishes with short
+ * tasks spread over every thread instead of one worker finishing a long one alone.
+ *
+ * @param tasks Task indices, from the most to the least expensive.
+ * @param num_threads Number of worker threads; 0 uses one per hardware core.
+ * @param body Runs one task. It is called concurrently from several threads and must not throw.
+ */
+WorkStealingStats run_work_stealing(std::span<std::uint32_t const> tasks, unsigned num_threads,
+                                    std::function<void(std::uint32_t task)> const& body);
@@ -1,5 +1,11 @@
+#pragma once
+
 /* Configuration constants for the game. */
 namespace Config {
-short const MAX_PLAYER_COUNT = 4;
+short const MAX_PLAYER_COUNT = 32;
 short const MAX_STARTING_ROUND = 10;
-}
\ No newline at end of file
+/* Most decks a shoe can hold; enough to deal MAX_STARTING_ROUND cards to MAX_PLAYER_COUNT players. */
+short const MAX_DECKS = 8;
+/* Reshuffles in a row without any card being placed before a round is declared a stalemate. */
+short const MAX_IDLE_RESHUFFLES = 8;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file BatchRunner.cpp
+ * @brief Implementation of the parallel batch runner.
+ */
+
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Allocations.h"
+#include "EventSink.h"
+#include "Game.h"
+#include "GameLog.h"
+#include "Player.h"
+#include "Random.h"
+
+namespace {
+
+/**
+ * @brief Number of games a worker claims from the shared counter at a time.
+ */
+constexpr std::uint64_t GAMES_PER_CHUNK = 256;
+
+/**
+ * @brief Plays games until the shared counter runs past the end of the batch.
+ */
+BatchResult run_worker(BatchConfig const& config, std::atomic<std::uint64_t>& next_game, unsigned worker) {
+    CountingSink counter;
+    std::optional<LogWriter> writer;
+    std::optional<RecordingSink> recorder;
+    std::optional<TeeSink> tee;
+    if (!config.record_path.empty()) {
+        writer.emplace(config.record_path + "." + std::to_string(worker));
+        recorder.emplace(*writer);
+        tee.emplace(counter, *recorder);
+    }
+    EventSink& sink = tee ? static_cast<EventSink&>(*tee) : counter;
+
+    // One game per worker, reset between games: after the first game nothing is allocated
+    std::vector<Player> players;
+    for (short i = 0; i < config.num_players; ++i) {
+        players.push_back(Player_factory("Player " + std::to_string(i + 1), config.starting_round));
+    }
+    Game game(std::move(players), config.starting_round, config.shuffle_enabled, sink, 0);
+    if (config.num_decks > 0) {
+        game.set_num_decks(config.num_decks);
+    }
+
+    BatchResult result;
+    bool warmed_up = false;
+    for (;;) {
+        std::uint64_t const first = next_game.fetch_add(GAMES_PER_CHUNK, std::memory_order_relaxed);
+        if (first >= config.num_games) {
+            break;
+        }
+        std::uint64_t const last = std::min(first + GAMES_PER_CHUNK, config.num_games);
+        for (std::uint64_t g = first; g < last; ++g) {
+            Allocations::Scope const allocations;
+            std::uint64_t const game_seed = stream_seed(config.seed, g);
+            game.reset(game_seed);
+            for (short i = 0; i < config.num_players; ++i) {
+                Strategy strategy = static_cast<std::size_t>(i) < config.strategies.size() ? config.strategies[i]
+                                                                                           : GreedyStrategy {};
+                if (auto* search = std::get_if<SearchStrategy>(&strategy)) {
+                    search->seed = stream_seed(game_seed, static_cast<std::uint64_t>(i));
+                }
+                game.set_strategy(static_cast<std::size_t>(i), strategy);
+            }
+            CountingSink const before = counter;
+            game.play();
+
+            std::array<short, Config::MAX_PLAYER_COUNT> final_rounds {};
+            for (short i = 0; i < config.num_players; ++i) {
+                final_rounds[i] = game.get_players()[i].get_round();
+            }
+            result.record_game(counter.rounds - before.rounds, counter.turns - before.turns,
+                               counter.reshuffles - before.reshuffles, counter.stalemates - before.stalemates,
+                               std::span(final_rounds).first(static_cast<std::size_t>(config.num_players)));
+            if (warmed_up) {
+                result.allocations += allocations.allocations();
+            }
+            warmed_up = true;
+        }
+    }
+    if (writer) {
+        writer->close();
+    }
+    return result;
+}
+
+}
+
+void BatchResult::record_game(std::uint64_t game_rounds, std::uint64_t game_turns, std::uint64_t game_reshuffles,
+                              std::uint64_t game_stalemates, std::span<short const> final_rounds) noexcept {
+    ++games;
+    rounds += game_rounds;
+    turns += game_turns;
+    reshuffles += game_reshuffles;
+    stalemates += game_stalemates;
+    for (size_t i = 0; i < final_rounds.size() && i < wins.size(); ++i) {
+        if (final_rounds[i] == 0) {
+            ++wins[i];
+        }
+    }
+    rounds_per_game.add(static_cast<double>(game_rounds));
+    turns_per_game.add(static_cast<double>(game_turns));
+    reshuffles_per_game.add(static_cast<double>(game_reshuffles));
+}
+
+void BatchResult::merge(BatchResult const& other) noexcept {
+    games += other.games;
+    rounds += other.rounds;
+    turns += other.turns;
+    reshuffles += other.reshuffles;
+    stalemates += other.stalemates;
+    allocations += other.allocations;
+    for (size_t i = 0; i < wins.size(); ++i) {
+        wins[i] += other.wins[i];
+    }
+    rounds_per_game.merge(other.rounds_per_game);
+    turns_per_game.merge(other.turns_per_game);
+    reshuffles_per_game.merge(other.reshuffles_per_game);
+}
+
+BatchResult run_batch(BatchConfig const& config) {
+    unsigned num_threads = config.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::atomic<std::uint64_t> next_game { 0 };
+    std::vector<BatchResult> results(num_threads);
+    std::vector<std::exception_ptr> errors(num_threads);
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(num_threads);
+        for (unsigned t = 0; t < num_threads; ++t) {
+            workers.emplace_back([&, t] {
+                try {
+                    results[t] = run_worker(config, next_game, t);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+    }
+    for (std::exception_ptr const& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    BatchResult total;
+    for (auto const& result : results) {
+        total.merge(result);
+    }
+    if (config.check_allocations && total.allocations > 0) {
+        throw std::runtime_error("The batch made " + std::to_string(total.allocations)
+                                 + " heap allocations after the first game of each worker");
+    }
+    return total;
+}
+
+void print_report(BatchResult const& result, short num_players) {
+    auto const print_distribution = [](char const* name, Distribution const& distribution) {
+        RunningStats const& stats = distribution.stats();
+        Interval const mean = stats.mean_interval();
+        std::println("{}: mean {:.2f} (95% CI {:.2f}-{:.2f}), sd {:.2f}, min {:.0f}, p50 {:.0f}, p90 {:.0f}, "
+                     "p99 {:.0f}, max {:.0f}",
+                     name, stats.mean(), mean.low, mean.high, stats.stddev(), stats.min(), distribution.quantile(0.5),
+                     distribution.quantile(0.9), distribution.quantile(0.99), stats.max());
+    };
+    print_distribution("Rounds per game", result.rounds_per_game);
+    print_distribution("Turns per game", result.turns_per_game);
+    print_distribution("Reshuffles per game", result.reshuffles_per_game);
+
+    double const games = static_cast<double>(result.games);
+    std::println("Stalemated rounds: {} ({:.2f}% of rounds)", result.stalemates,
+                 result.rounds > 0 ? 100.0 * static_cast<double>(result.stalemates) / static_cast<double>(result.rounds)
+                                   : 0.0);
+    for (short i = 0; i < num_players; ++i) {
+        Interval const rate = wilson_interval(result.wins[i], result.games);
+        std::println("Player {} wins: {} ({:.2f}%, 95% CI {:.2f}%-{:.2f}%)", i + 1, result.wins[i],
+                     games > 0 ? 100.0 * static_cast<double>(result.wins[i]) / games : 0.0, 100.0 * rate.low,
+                     100.0 * rate.high);
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file CardTracker.cpp
+ * @brief Implementation of the CardTracker.
+ */
+
+#include "CardTracker.h"
+
+CardTracker::CardTracker() noexcept {
+    clear();
+}
+
+void CardTracker::clear() noexcept {
+    unseen_by_rank.fill(static_cast<std::uint8_t>(NUM_SUITS * num_decks));
+    unseen_by_rank[0] = 0;
+    discarded_by_rank.fill(0);
+    unseen_count = static_cast<std::uint16_t>(num_decks * Deck::CARDS_PER_DECK);
+    discard_size = 0;
+}
+
+void CardTracker::on_first_discard(Card const& card) noexcept {
+    --unseen_by_rank[rank_of(card)];
+    --unseen_count;
+    push_discard(card);
+}
+
+void CardTracker::on_reshuffle() noexcept {
+    if (discard_size == 0) {
+        return;
+    }
+    Card const top = discard_pile[discard_size - 1];
+    for (std::size_t rank = 1; rank < unseen_by_rank.size(); ++rank) {
+        unseen_by_rank[rank] += discarded_by_rank[rank];
+    }
+    unseen_count += discard_size;
+    discarded_by_rank.fill(0);
+
+    // The top card stays in the discard pile
+    --unseen_by_rank[rank_of(top)];
+    --unseen_count;
+    discarded_by_rank[rank_of(top)] = 1;
+    discard_pile[0] = top;
+    discard_size = 1;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file Comparison.cpp
+ * @brief Implementation of the head-to-head strategy comparison.
+ */
+
+#include "Comparison.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EventSink.h"
+#include "Game.h"
+#include "Player.h"
+#include "Random.h"
+
+namespace {
+
+/**
+ * @brief Pairs every worker plays per batch. The test looks at the pairs of a batch once all are played, so this
+ * bounds the pairs played past the point where the comparison is resolved.
+ */
+constexpr std::uint64_t PAIRS_PER_WORKER = 64;
+
+/**
+ * @brief Pairs a worker claims from the batch at a time.
+ */
+constexpr std::uint64_t PAIRS_PER_CLAIM = 8;
+
+/**
+ * @brief Rounds each strategy had left at the end of both games of a pair.
+ */
+struct PairRounds {
+    std::array<short, 2> a;
+    std::array<short, 2> b;
+};
+
+void validate(ComparisonConfig const& config) {
+    if (config.starting_round < 1 || config.starting_round > Config::MAX_STARTING_ROUND) {
+        throw std::invalid_argument("starting_round must be between 1 and "
+                                    + std::to_string(Config::MAX_STARTING_ROUND));
+    }
+    if (!(config.margin > 0.0 && config.margin < 0.5)) {
+        throw std::invalid_argument("The margin must be between 0 and 0.5");
+    }
+    if (config.min_pairs < 2 || config.max_pairs < config.min_pairs) {
+        throw std::invalid_argument("A comparison needs at least 2 pairs, and max_pairs at least min_pairs");
+    }
+}
+
+/**
+ * @brief Plays both games of pair p on a game of two seats. A sits in seat 0 in the first game and in seat 1 in the
+ * second.
+ */
+PairRounds play_pair(ComparisonConfig const& config, Game& game, std::uint64_t p) {
+    std::uint64_t const first_seed = stream_seed(config.seed, 2 * p);
+    std::uint64_t const second_seed = config.mirrored ? first_seed : stream_seed(config.seed, 2 * p + 1);
+
+    PairRounds rounds {};
+    for (std::size_t g = 0; g < 2; ++g) {
+        std::uint64_t const game_seed = g == 0 ? first_seed : second_seed;
+        game.reset(game_seed);
+        // Searches are seeded by strategy rather than by seat, so a mirrored game replays A's rollouts too
+        Strategy a = config.a;
+        Strategy b = config.b;
+        if (auto* search = std::get_if<SearchStrategy>(&a)) {
+            search->seed = stream_seed(game_seed, 0);
+        }
+        if (auto* search = std::get_if<SearchStrategy>(&b)) {
+            search->seed = stream_seed(game_seed, 1);
+        }
+        std::size_t const seat_a = g;
+        game.set_strategy(seat_a, a);
+        game.set_strategy(1 - seat_a, b);
+        game.play();
+        rounds.a[g] = game.get_players()[seat_a].get_round();
+        rounds.b[g] = game.get_players()[1 - seat_a].get_round();
+    }
+    return rounds;
+}
+
+double score(short a_rounds, short b_rounds) noexcept {
+    return a_rounds < b_rounds ? 1.0 : a_rounds == b_rounds ? 0.5 : 0.0;
+}
+
+}
+
+double ComparisonResult::variance_reduction() const noexcept {
+    double const independent = game_scores.variance() / 2.0;
+    double const measured = pair_scores.variance();
+    if (measured <= 0.0) {
+        return independent > 0.0 ? std::numeric_limits<double>::infinity() : 1.0;
+    }
+    return independent / measured;
+}
+
+ComparisonResult compare_strategies(ComparisonConfig const& config) {
+    validate(config);
+    Sprt const a_test(0.5, 0.5 + config.margin, config.alpha, config.beta);
+    Sprt const b_test(0.5, 0.5 - config.margin, config.alpha, config.beta);
+
+    unsigned num_threads = config.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // One game per worker, reset for every game of every batch
+    NullSink sink;
+    std::vector<std::unique_ptr<Game>> games;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        std::vector<Player> players { Player_factory("Player 1", config.starting_round),
+                                      Player_factory("Player 2", config.starting_round) };
+        games.push_back(std::make_unique<Game>(std::move(players), config.starting_round, true, sink, 0));
+    }
+
+    std::uint64_t const pairs_per_batch = PAIRS_PER_WORKER * num_threads;
+    std::vector<PairRounds> batch(pairs_per_batch);
+    ComparisonResult result;
+    Sprt::Decision a_decision = Sprt::Decision::CONTINUE;
+    Sprt::Decision b_decision = Sprt::Decision::CONTINUE;
+
+    for (std::uint64_t begin = 0; begin < config.max_pairs && result.verdict == ComparisonResult::Verdict::UNRESOLVED;
+         begin += pairs_per_batch) {
+        std::uint64_t const end = std::min(begin + pairs_per_batch, config.max_pairs);
+        std::atomic<std::uint64_t> next_pair { begin };
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(num_threads);
+            for (unsigned t = 0; t < num_threads; ++t) {
+                workers.emplace_back([&, t] {
+                    for (;;) {
+                        std::uint64_t const first = next_pair.fetch_add(PAIRS_PER_CLAIM, std::memory_order_relaxed);
+                        if (first >= end) {
+                            return;
+                        }
+                        for (std::uint64_t p = first; p < std::min(first + PAIRS_PER_CLAIM, end); ++p) {
+                            batch[p - begin] = play_pair(config, *games[t], p);
+                        }
+                    }
+                });
+            }
+        }
+
+        for (std::uint64_t p = begin; p < end; ++p) {
+            PairRounds const& rounds = batch[p - begin];
+            double const first = score(rounds.a[0], rounds.b[0]);
+            double const second = score(rounds.a[1], rounds.b[1]);
+            result.game_scores.add(first);
+            result.game_scores.add(second);
+            result.pair_scores.add((first + second) / 2.0);
+            for (std::size_t g = 0; g < 2; ++g) {
+                result.wins_a += rounds.a[g] == 0 ? 1 : 0;
+                result.wins_b += rounds.b[g] == 0 ? 1 : 0;
+            }
+
+            if (result.pair_scores.count() < config.min_pairs) {
+                continue;
+            }
+            // Each test stops for good once it accepts either hypothesis
+            if (a_decision == Sprt::Decision::CONTINUE) {
+                a_decision = a_test.decide(result.pair_scores);
+            }
+            if (b_decision == Sprt::Decision::CONTINUE) {
+                b_decision = b_test.decide(result.pair_scores);
+            }
+            if (a_decision == Sprt::Decision::ACCEPT_H1) {
+                result.verdict = ComparisonResult::Verdict::A_STRONGER;
+            } else if (b_decision == Sprt::Decision::ACCEPT_H1) {
+                result.verdict = ComparisonResult::Verdict::B_STRONGER;
+            } else if (a_decision == Sprt::Decision::ACCEPT_H0 && b_decision == Sprt::Decision::ACCEPT_H0) {
+                result.verdict = ComparisonResult::Verdict::NO_DIFFERENCE;
+            }
+            if (result.verdict != ComparisonResult::Verdict::UNRESOLVED) {
+                break;
+            }
+        }
+        if (config.on_progress) {
+            config.on_progress(result.pair_scores.count(), result.pair_scores);
+        }
+    }
+
+    result.llr_a = a_test.llr(result.pair_scores);
+    result.llr_b = b_test.llr(result.pair_scores);
+    return result;
+}
@@ -6,77 +6,197 @@
 #include "Deck.h"
 
 #include <algorithm>
-#include <iostream>
 #include <random>
-#include <ranges>
-
-Deck::Deck() noexcept {
-    discard_pile.clear();
-    draw_pile.clear();
-    draw_pile.reserve(DEFAULT_DECK_SIZE);
-    for (auto suit : std::views::iota(0, static_cast<int>(NUM_SUITS))) {
-        for (auto rank : std::views::iota(0, static_cast<int>(NUM_RANKS))) {
-            draw_pile.emplace_back(RANK_VALUES_BY_WEIGHT[rank], static_cast<Card::Suit>(suit));
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Metrics.h"
+
+namespace {
+
+/**
+ * @brief The full deck in standard order, copied in by Deck::redeal.
+ */
+constexpr std::array<Card, NUM_SUITS * NUM_RANKS> STANDARD_ORDER = [] {
+    std::array<Card, NUM_SUITS * NUM_RANKS> order;
+    for (int suit = 0; suit < NUM_SUITS; ++suit) {
+        for (int rank = 0; rank < NUM_RANKS; ++rank) {
+            order[suit * NUM_RANKS + rank] = Card(RANK_VALUES_BY_WEIGHT[rank], SUIT_VALUES_BY_WEIGHT[suit]);
         }
     }
+    return order;
+}();
+
+}
+
+Deck::Deck() noexcept
+    : Deck((static_cast<std::uint64_t>(std::random_device {}()) << 32) ^ std::random_device {}()) {}
+
+Deck::Deck(std::uint64_t seed) noexcept
+    : rng(seed) {
+    redeal();
+}
+
+void Deck::seed(std::uint64_t seed) noexcept {
+    rng = Rng(seed);
+}
+
+std::array<Card, NUM_SUITS * NUM_RANKS> const& Deck::standard_order() noexcept {
+    return STANDARD_ORDER;
+}
+
+void Deck::redeal() noexcept {
+    for (int deck = 0; deck < num_decks; ++deck) {
+        std::ranges::copy(STANDARD_ORDER, cards.begin() + deck * CARDS_PER_DECK);
+    }
+    draw_begin = 0;
+    draw_count = shoe_size;
+    discard_count = 0;
+    unshuffled_count = 0;
+}
+
+void Deck::save(Snapshot& snapshot) const noexcept {
+    snapshot.cards = cards;
+    snapshot.rng_state = rng.get_state();
+    snapshot.num_decks = num_decks;
+    snapshot.shoe_size = shoe_size;
+    snapshot.draw_begin = draw_begin;
+    snapshot.draw_count = draw_count;
+    snapshot.discard_count = discard_count;
+    snapshot.unshuffled_count = unshuffled_count;
+    snapshot.shuffle_mode = shuffle_mode;
+}
+
+void Deck::restore(Snapshot const& snapshot) noexcept {
+    cards = snapshot.cards;
+    rng = Rng(snapshot.rng_state);
+    num_decks = snapshot.num_decks;
+    shoe_size = snapshot.shoe_size;
+    draw_begin = snapshot.draw_begin;
+    draw_count = snapshot.draw_count;
+    discard_count = snapshot.discard_count;
+    unshuffled_count = snapshot.unshuffled_count;
+    shuffle_mode = snapshot.shuffle_mode;
+    script = {};
+}
+
+void Deck::set_num_decks(short num_decks_in) {
+    if (num_decks_in < 1 || num_decks_in > Config::MAX_DECKS) {
+        throw std::invalid_argument("num_decks must be between 1 and " + std::to_string(Config::MAX_DECKS));
+    }
+    num_decks = num_decks_in;
+    shoe_size = static_cast<std::uint16_t>(num_decks * CARDS_PER_DECK);
+    redeal();
 }
 
 Card Deck::deal_one() noexcept {
     if (empty()) {
         reset();
     }
-    Card dealt_card = draw_pile.back();
-    draw_pile.pop_back();
-    return dealt_card;
+    if (!script.empty()) {
+        Card const wanted = script.front();
+        script = script.subspan(1);
+        for (int i = draw_count - 1; i >= 0; --i) {
+            if (cards[wrap(draw_begin + i)].get_bits() == wanted.get_bits()) {
+                std::swap(cards[wrap(draw_begin + i)], cards[wrap(draw_begin + draw_count - 1)]);
+                --draw_count;
+                unshuffled_count = std::min(unshuffled_count, draw_count);
+                return wanted;
+            }
+        }
+        // The recorded game took a different path; stop following the script
+        script = {};
+    }
+    if (unshuffled_count > 0) {
+        // One step of Fisher-Yates over the part of the pile that has not been shuffled yet
+        int const top = draw_count - 1;
+        int const pick = top - static_cast<int>(random_below(rng, unshuffled_count));
+        std::swap(cards[wrap(draw_begin + top)], cards[wrap(draw_begin + pick)]);
+        --unshuffled_count;
+    }
+    --draw_count;
+    return cards[wrap(draw_begin + draw_count)];
 }
 
 void Deck::reset() noexcept {
     if (!discard_pile_empty()) {
-        Card top_discard = peek_discard();
-        discard_pile.pop_back();
-        draw_pile.insert(draw_pile.end(), discard_pile.begin(), discard_pile.end());
-        discard_pile.clear();
-        discard_pile.push_back(top_discard);
+        Metrics::add(Metrics::Counter::RESHUFFLES);
+        // The discard pile lies newest first; turn it over so the most recent discard is dealt first
+        int const recycled = discard_count - 1;
+        for (int low = -recycled, high = -1; low < high; ++low, --high) {
+            std::swap(cards[wrap(draw_begin + low)], cards[wrap(draw_begin + high)]);
+        }
+        draw_begin = static_cast<std::uint16_t>(wrap(draw_begin - recycled));
+        draw_count = static_cast<std::uint16_t>(draw_count + recycled);
+        discard_count = 1;
     }
 }
 
-void Deck::redeal() noexcept {
-    *this = Deck {};
+void Deck::set_script(std::span<Card const> order) noexcept {
+    script = order;
+}
+
+void Deck::set_piles(std::span<Card const> draw_pile, std::span<Card const> discard_pile) noexcept {
+    // Discard pile in the first slots with its top at slot 0, draw pile right after it
+    std::ranges::copy(discard_pile, cards.begin());
+    std::ranges::copy(draw_pile, cards.begin() + discard_pile.size());
+    draw_begin = static_cast<std::uint16_t>(discard_pile.size());
+    draw_count = static_cast<std::uint16_t>(draw_pile.size());
+    discard_count = static_cast<std::uint16_t>(discard_pile.size());
+    unshuffled_count = 0;
+    script = {};
+}
+
+void Deck::set_shuffle_mode(ShuffleMode mode) noexcept {
+    shuffle_mode = mode;
 }
 
 void Deck::shuffle() noexcept {
-    static std::mt19937_64 rng(std::random_device {}());
-    std::ranges::shuffle(draw_pile, rng);
+    if (shuffle_mode == ShuffleMode::LAZY) {
+        unshuffled_count = draw_count;
+        return;
+    }
+    unshuffled_count = 0;
+    for (int i = draw_count - 1; i > 0; --i) {
+        int const j = static_cast<int>(random_below(rng, static_cast<std::uint32_t>(i + 1)));
+        std::swap(cards[wrap(draw_begin + i)], cards[wrap(draw_begin + j)]);
+    }
 }
 
 bool Deck::empty() const noexcept {
-    return draw_pile.empty();
+    return draw_count == 0;
 }
 
 int Deck::size() const noexcept {
-    return static_cast<int>(draw_pile.size());
+    return draw_count;
+}
+
+int Deck::discard_size() const noexcept {
+    return discard_count;
 }
 
 bool Deck::discard_pile_empty() const noexcept {
-    return discard_pile.empty();
+    return discard_count == 0;
 }
 
 Card const& Deck::peek_discard() const {
     if (discard_pile_empty()) {
         throw std::out_of_range("Discard pile is empty");
     }
-    return discard_pile.back();
+    return cards[wrap(draw_begin - discard_count)];
 }
 
 void Deck::discard(Card const& card) noexcept {
-    discard_pile.push_back(card);
+    ++discard_count;
+    cards[wrap(draw_begin - discard_count)] = card;
 }
 
 Card const Deck::take_discard() {
     if (discard_pile_empty()) {
         throw std::out_of_range("Discard pile is empty");
     }
-    Card const& top_card = discard_pile.back();
-    discard_pile.pop_back();
+    Card const top_card = cards[wrap(draw_begin - discard_count)];
+    --discard_count;
     return top_card;
-}
\ No newline at end of file
+}
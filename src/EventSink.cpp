@@ -0,0 +1,184 @@
+/**
+ * @file EventSink.cpp
+ * @brief Implementation of the text and counting event sinks.
+ */
+
+#include "EventSink.h"
+
+#include <format>
+#include <iterator>
+#include <new>
+
+#include "Hand.h"
+#include "Player.h"
+
+void TextSink::on_game_start() noexcept {
+    logger.log(Logger::Level::INFO, "Game start!\n");
+}
+
+void TextSink::on_deal(Player const& player, Card const& card) noexcept {
+    logger.log(Logger::Level::DEBUG, "\n{} was dealt: {}", player.get_name(), card);
+}
+
+void TextSink::on_deal_complete(Player const& player, short num_cards) noexcept {
+    logger.log(Logger::Level::DEBUG, "{} was dealt {} {}.\n", player.get_name(), num_cards,
+               num_cards == 1 ? "card" : "cards");
+}
+
+void TextSink::on_turn(Player const& player) noexcept {
+    logger.log(Logger::Level::DEBUG, "{}'s turn...", player.get_name());
+}
+
+void TextSink::on_turn_state(Player const& player, Hand const& hand, Card const& top_discard) noexcept {
+    logger.log(Logger::Level::DEBUG, "{}'s turn. Current hand: {}", player.get_name(), hand);
+    logger.log(Logger::Level::DEBUG, "Top of discard pile: {}", top_discard);
+}
+
+void TextSink::on_take_discard(Player const& player, Card const& card) noexcept {
+    logger.log(Logger::Level::DEBUG, "{} takes from discard pile: {}", player.get_name(), card);
+}
+
+void TextSink::on_draw(Player const& player, Card const& card) noexcept {
+    logger.log(Logger::Level::DEBUG, "{} draws from deck: {}", player.get_name(), card);
+}
+
+void TextSink::on_card_played(Card const& card, Card const& replaced) noexcept {
+    logger.log(Logger::Level::DEBUG, "Played card: {}, replaced card: {}", card, replaced);
+}
+
+void TextSink::on_card_not_playable(Card const& card) noexcept {
+    logger.log(Logger::Level::DEBUG, "Card {} is not playable.", card);
+}
+
+void TextSink::on_discard(Player const& player, Card const& card) noexcept {
+    logger.log(Logger::Level::DEBUG, "{} discards: {}", player.get_name(), card);
+}
+
+void TextSink::on_stalemate() noexcept {
+    logger.log(Logger::Level::INFO, "===========\nStalemate! No card can be placed anymore, the round is replayed.");
+}
+
+void TextSink::on_round_over(std::span<Player const> players) noexcept {
+    if (!logger.enabled(Logger::Level::INFO)) {
+        return;
+    }
+    try {
+        text = "===========\nRound over. Current scores:\n";
+        for (auto const& player : players) {
+            std::format_to(std::back_inserter(text), "{}", player);
+        }
+        text += '\n';
+    } catch (std::bad_alloc const&) {
+        logger.log(Logger::Level::ERROR, "===========\nRound over; out of memory for the scores.");
+        return;
+    }
+    logger.write(Logger::Level::INFO, text);
+}
+
+void TextSink::on_game_over(std::span<Player const>) noexcept {
+    logger.log(Logger::Level::INFO, "===========\nGame over!");
+}
+
+void TextSink::on_final_scores(std::span<Player const> players) noexcept {
+    logger.log(Logger::Level::INFO, "Final Scores:");
+    for (auto const& player : players) {
+        if (player.get_round() == 0) {
+            logger.log(Logger::Level::INFO, "{} is the winner!", player.get_name());
+        } else {
+            logger.log(Logger::Level::INFO, "{}: Round {}", player.get_name(), player.get_round());
+        }
+    }
+}
+
+void CountingSink::on_final_scores(std::span<Player const> players) noexcept {
+    for (size_t i = 0; i < players.size() && i < wins.size(); ++i) {
+        if (players[i].get_round() == 0) {
+            ++wins[i];
+        }
+    }
+}
+
+void TeeSink::on_game_setup(std::span<Player const> players, short starting_round, short num_decks) noexcept {
+    first.on_game_setup(players, starting_round, num_decks);
+    second.on_game_setup(players, starting_round, num_decks);
+}
+
+void TeeSink::on_game_start() noexcept {
+    first.on_game_start();
+    second.on_game_start();
+}
+
+void TeeSink::on_deal(Player const& player, Card const& card) noexcept {
+    first.on_deal(player, card);
+    second.on_deal(player, card);
+}
+
+void TeeSink::on_deal_complete(Player const& player, short num_cards) noexcept {
+    first.on_deal_complete(player, num_cards);
+    second.on_deal_complete(player, num_cards);
+}
+
+void TeeSink::on_first_discard(Card const& card) noexcept {
+    first.on_first_discard(card);
+    second.on_first_discard(card);
+}
+
+void TeeSink::on_turn(Player const& player) noexcept {
+    first.on_turn(player);
+    second.on_turn(player);
+}
+
+void TeeSink::on_turn_state(Player const& player, Hand const& hand, Card const& top_discard) noexcept {
+    first.on_turn_state(player, hand, top_discard);
+    second.on_turn_state(player, hand, top_discard);
+}
+
+void TeeSink::on_take_discard(Player const& player, Card const& card) noexcept {
+    first.on_take_discard(player, card);
+    second.on_take_discard(player, card);
+}
+
+void TeeSink::on_draw(Player const& player, Card const& card) noexcept {
+    first.on_draw(player, card);
+    second.on_draw(player, card);
+}
+
+void TeeSink::on_card_played(Card const& card, Card const& replaced) noexcept {
+    first.on_card_played(card, replaced);
+    second.on_card_played(card, replaced);
+}
+
+void TeeSink::on_card_not_playable(Card const& card) noexcept {
+    first.on_card_not_playable(card);
+    second.on_card_not_playable(card);
+}
+
+void TeeSink::on_discard(Player const& player, Card const& card) noexcept {
+    first.on_discard(player, card);
+    second.on_discard(player, card);
+}
+
+void TeeSink::on_reshuffle() noexcept {
+    first.on_reshuffle();
+    second.on_reshuffle();
+}
+
+void TeeSink::on_stalemate() noexcept {
+    first.on_stalemate();
+    second.on_stalemate();
+}
+
+void TeeSink::on_round_over(std::span<Player const> players) noexcept {
+    first.on_round_over(players);
+    second.on_round_over(players);
+}
+
+void TeeSink::on_game_over(std::span<Player const> players) noexcept {
+    first.on_game_over(players);
+    second.on_game_over(players);
+}
+
+void TeeSink::on_final_scores(std::span<Player const> players) noexcept {
+    first.on_final_scores(players);
+    second.on_final_scores(players);
+}
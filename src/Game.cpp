@@ -1,82 +1,319 @@
 #include "Game.h"
 
 #include <algorithm>
-#include <print>
+#include <array>
+#include <cstring>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
-Game::Game(std::vector<Player*> const& players_in, short starting_round_in, bool shuffle_enabled_in)
+#include "Metrics.h"
+#include "const.h"
+
+namespace {
+
+/**
+ * @brief Checks that a table fits the per-seat buffers of a game.
+ */
+void check_player_count(std::size_t num_players) {
+    if (num_players < 1 || num_players > static_cast<std::size_t>(Config::MAX_PLAYER_COUNT)) {
+        throw std::invalid_argument("num_players must be between 1 and " + std::to_string(Config::MAX_PLAYER_COUNT));
+    }
+}
+
+}
+
+Game::Game(std::vector<Player> players_in, short starting_round_in, bool shuffle_enabled_in, EventSink& sink_in)
     : deck()
-    , players(players_in)
+    , players(std::move(players_in))
+    , starting_round(starting_round_in)
+    , shuffle_enabled(shuffle_enabled_in)
+    , sink(sink_in)
+    , events(tracker, sink) {
+    check_player_count(players.size());
+    deck.set_shuffle_mode(Deck::ShuffleMode::LAZY);
+    set_num_decks(min_decks(players.size(), starting_round));
+}
+
+Game::Game(std::vector<Player> players_in, short starting_round_in, bool shuffle_enabled_in, EventSink& sink_in,
+           std::uint64_t seed)
+    : deck(seed)
+    , players(std::move(players_in))
     , starting_round(starting_round_in)
-    , shuffle_enabled(shuffle_enabled_in) {
+    , shuffle_enabled(shuffle_enabled_in)
+    , sink(sink_in)
+    , events(tracker, sink) {
+    check_player_count(players.size());
+    deck.set_shuffle_mode(Deck::ShuffleMode::LAZY);
+    set_num_decks(min_decks(players.size(), starting_round));
+}
+
+void Game::play() {
+    start();
+    while (play_round());
+    print_scores();
+}
+
+void Game::reset(std::uint64_t seed) noexcept {
+    deck.seed(seed);
+    deck.set_script({});
+    deck.redeal();
+    for (auto& player : players) {
+        player.reset(starting_round);
+    }
+}
+
+void Game::set_strategy(std::size_t seat, Strategy strategy) noexcept {
+    players[seat].set_strategy(strategy);
+}
+
+void Game::start() {
+    events.on_game_setup(players, starting_round, deck.get_num_decks());
     if (shuffle_enabled) {
         deck.shuffle();
     }
-    deal(std::vector<short>(players.size(), starting_round));
+    std::array<short, Config::MAX_PLAYER_COUNT> cards_per_player;
+    cards_per_player.fill(starting_round);
+    deal(std::span(cards_per_player).first(players.size()));
     discard_first_card();
-    std::println("Game start!\n");
-    while (play_round());
-    print_scores();
+    events.on_game_start();
+}
+
+void Game::set_deck_order(std::span<Card const> order) noexcept {
+    deck.set_script(order);
+}
+
+void Game::set_num_decks(short num_decks) {
+    if (num_decks < min_decks(players.size(), starting_round)) {
+        throw std::invalid_argument(std::to_string(num_decks) + " decks cannot deal " + std::to_string(starting_round)
+                                    + " cards to " + std::to_string(players.size()) + " players");
+    }
+    deck.set_num_decks(num_decks);
+}
+
+void Game::save(GameSnapshot& snapshot) const noexcept {
+    // Padding and unused seats included, so snapshots of the same state are the same bytes
+    std::memset(static_cast<void*>(&snapshot), 0, sizeof(snapshot));
+    deck.save(snapshot.deck);
+    tracker.save(snapshot.tracker);
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        snapshot.hands[i] = players[i].get_hand();
+        snapshot.rounds[i] = players[i].get_round();
+        auto const* search = std::get_if<SearchStrategy>(&players[i].get_strategy());
+        snapshot.search_decisions[i] = search ? search->get_decisions() : 0;
+    }
+    snapshot.num_players = static_cast<short>(players.size());
+    snapshot.starting_round = starting_round;
+    snapshot.shuffle_enabled = shuffle_enabled;
+    snapshot.round_turns = round_turns;
+    snapshot.face_up = static_cast<std::uint16_t>(face_up);
+    snapshot.idle_reshuffles = idle_reshuffles;
+    snapshot.seat = static_cast<std::uint8_t>(seat);
+    snapshot.completed = static_cast<std::uint32_t>(players_won.to_ulong());
+    snapshot.turn_begun = turn_begun;
+}
+
+void Game::restore(GameSnapshot const& snapshot) {
+    if (static_cast<std::size_t>(snapshot.num_players) != players.size()) {
+        throw std::invalid_argument("The snapshot is of a game of " + std::to_string(snapshot.num_players)
+                                    + " players, not " + std::to_string(players.size()));
+    }
+    deck.restore(snapshot.deck);
+    tracker.restore(snapshot.tracker);
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        players[i].restore(snapshot.rounds[i], snapshot.hands[i]);
+        Strategy strategy = players[i].get_strategy();
+        if (auto* search = std::get_if<SearchStrategy>(&strategy)) {
+            search->set_decisions(snapshot.search_decisions[i]);
+            players[i].set_strategy(strategy);
+        }
+    }
+    starting_round = snapshot.starting_round;
+    shuffle_enabled = snapshot.shuffle_enabled;
+    round_turns = snapshot.round_turns;
+    face_up = snapshot.face_up;
+    idle_reshuffles = snapshot.idle_reshuffles;
+    seat = snapshot.seat;
+    players_won = snapshot.completed;
+    turn_begun = snapshot.turn_begun;
 }
 
-void Game::deal(std::vector<short> cards_per_player) {
+short Game::min_decks(std::size_t num_players, short starting_round) noexcept {
+    std::size_t const cards = num_players * static_cast<std::size_t>(std::max<short>(starting_round, 0)) + 1;
+    return static_cast<short>((cards + Deck::CARDS_PER_DECK - 1) / Deck::CARDS_PER_DECK);
+}
+
+void Game::deal(std::span<short const> cards_per_player) {
+    Metrics::PhaseTimer const timer(Metrics::Counter::DEAL_NANOSECONDS);
     for (size_t i = 0; i < players.size(); ++i) {
         short const num_cards = cards_per_player[i];
         for (short j = 0; j < num_cards; ++j) {
             Card const dealt_card = deck.deal_one();
-            players[i]->add_card(dealt_card);
-            std::println("\n{} was dealt: {}", players[i]->get_name(), dealt_card);
+            players[i].add_card(dealt_card);
+            events.on_deal(players[i], dealt_card);
         }
-        std::println("{} was dealt {} {}.\n", players[i]->get_name(), num_cards, num_cards == 1 ? "card" : "cards");
+        events.on_deal_complete(players[i], num_cards);
     }
 }
 
 void Game::discard_first_card() {
+    Metrics::PhaseTimer const timer(Metrics::Counter::DEAL_NANOSECONDS);
     Card first_card = deck.deal_one();
     deck.discard(first_card);
+    events.on_first_discard(first_card);
+    begin_round();
+}
+
+std::bitset<Config::MAX_PLAYER_COUNT> Game::take_turns() {
+    Metrics::PhaseTimer const timer(Metrics::Counter::TURN_NANOSECONDS);
+    while (!round_over() && (turn_begun || begin_turn())) {
+        finish_turn(players[seat].wants_discard(deck, players, tracker));
+    }
+    end_round();
+    return players_won;
+}
+
+std::generator<GameStep> Game::steps() {
+    return play_steps(true);
 }
 
-std::vector<bool> Game::take_turns() {
-    std::vector<bool> players_won(players.size(), false);
-    while (!std::ranges::any_of(players_won.begin(), players_won.end(), [](bool b) { return b; })) {
-        for (size_t i = 0; i < players.size(); ++i) {
-            auto* player = players[i];
-            if (deck.empty()) {
-                deck.reset();
-                if (shuffle_enabled) {
-                    deck.shuffle();
+std::generator<GameStep> Game::resume() {
+    return play_steps(false);
+}
+
+std::generator<GameStep> Game::play_steps(bool from_start) {
+    if (from_start) {
+        start();
+    }
+    for (;;) {
+        while (!round_over()) {
+            // Timed in pieces, so the time the game spends paused at a step is not counted
+            if (!turn_begun) {
+                Metrics::PhaseTimer const timer(Metrics::Counter::TURN_NANOSECONDS);
+                if (!begin_turn()) {
+                    break;
                 }
             }
-            std::println("{}'s turn...", player->get_name());
-            players_won[i] = player->take_turn(deck);
+            auto const turn_seat = static_cast<std::uint8_t>(seat);
+            auto const& player = players[seat];
+            bool const external = std::holds_alternative<ExternalStrategy>(player.get_strategy());
+            if (external) {
+                decision.reset();
+                co_yield GameStep { GameStep::Kind::DECISION, turn_seat };
+                if (!decision) {
+                    throw std::logic_error(player.get_name() + " was asked for a decision and none was given");
+                }
+            }
+            bool take_discard = false;
+            {
+                Metrics::PhaseTimer const timer(Metrics::Counter::TURN_NANOSECONDS);
+                take_discard = external ? *decision : player.wants_discard(deck, players, tracker);
+                finish_turn(take_discard);
+            }
+            co_yield GameStep { GameStep::Kind::TURN, turn_seat, take_discard, players_won[turn_seat] };
         }
+        end_round();
+        if (!next_round(players_won)) {
+            print_scores();
+            co_yield GameStep { GameStep::Kind::GAME_OVER };
+            co_return;
+        }
+        co_yield GameStep { GameStep::Kind::ROUND_OVER };
     }
-    return players_won;
+}
+
+void Game::begin_round() noexcept {
+    face_up = count_face_up();
+    idle_reshuffles = 0;
+    round_turns = 0;
+    seat = 0;
+    players_won.reset();
+    turn_begun = false;
+}
+
+bool Game::round_over() const noexcept {
+    // Once a hand is completed, the players after it still get their last turn
+    return seat == 0 && players_won.any();
+}
+
+bool Game::begin_turn() {
+    if (!prepare_turn()) {
+        return false;
+    }
+    auto const& player = players[seat];
+    events.on_turn(player);
+    events.on_turn_state(player, player.get_hand(), deck.peek_discard());
+    turn_begun = true;
+    return true;
+}
+
+void Game::finish_turn(bool take_discard) noexcept {
+    turn_begun = false;
+    players_won[seat] = players[seat].play_turn(take_discard, deck, events);
+    ++round_turns;
+    seat = seat + 1 == players.size() ? 0 : seat + 1;
+}
+
+bool Game::prepare_turn() {
+    if (!deck.empty()) [[likely]] {
+        return true;
+    }
+    // Every card has cycled through the draw pile since the last reshuffle; if nobody managed to place one of them
+    // several times in a row, the cards everybody needs are stuck face down in hands.
+    size_t const now_face_up = count_face_up();
+    if (now_face_up != face_up) {
+        face_up = now_face_up;
+        idle_reshuffles = 0;
+    } else if (++idle_reshuffles > Config::MAX_IDLE_RESHUFFLES) {
+        events.on_stalemate();
+        Metrics::add(Metrics::Counter::STALEMATES);
+        return false;
+    }
+    deck.reset();
+    events.on_reshuffle();
+    if (shuffle_enabled) {
+        deck.shuffle();
+    }
+    return true;
+}
+
+void Game::end_round() noexcept {
+    Metrics::add(Metrics::Counter::ROUNDS);
+    Metrics::add(Metrics::Counter::TURNS, round_turns);
+    Metrics::observe(Metrics::Histogram::TURNS_PER_ROUND, round_turns);
+}
+
+size_t Game::count_face_up() const noexcept {
+    size_t face_up = 0;
+    for (auto const& player : players) {
+        face_up += player.get_hand().count_showing();
+    }
+    return face_up;
 }
 
 bool Game::game_over() const noexcept {
-    return std::ranges::any_of(players.begin(), players.end(), [](auto* p) { return p->get_round() == 0; });
+    return std::ranges::any_of(players.begin(), players.end(), [](auto const& p) { return p.get_round() == 0; });
 }
 
 bool Game::play_round() {
-    auto players_won = take_turns();
+    return next_round(take_turns());
+}
+
+bool Game::next_round(std::bitset<Config::MAX_PLAYER_COUNT> players_won) {
     for (size_t i = 0; i < players.size(); ++i) {
         if (players_won[i]) {
-            players[i]->register_win();
+            players[i].register_win();
         }
     }
 
     bool const is_game_over = game_over();
 
     if (!is_game_over) {
-        std::println("===========\nRound over. Current scores:");
-        for (auto* player : players) {
-            std::print("{}", *player);
-        }
-        std::println("");
+        events.on_round_over(players);
     } else {
-        std::println("===========\nGame over!");
+        events.on_game_over(players);
         return false;
     }
 
@@ -85,30 +322,29 @@ bool Game::play_round() {
         deck.shuffle();
     }
 
-    std::vector<short> rounds_remaining;
-    for (auto* player : players) {
-        rounds_remaining.push_back(player->get_round());
-        player->reset_hand();
+    std::array<short, Config::MAX_PLAYER_COUNT> rounds_remaining;
+    for (size_t i = 0; i < players.size(); ++i) {
+        rounds_remaining[i] = players[i].get_round();
+        players[i].reset_hand();
     }
-    deal(rounds_remaining);
+    deal(std::span(rounds_remaining).first(players.size()));
     discard_first_card();
 
     return true;
 }
 
-void Game::print_scores() const {
-    std::println("Final Scores:");
-    for (auto* player : players) {
-        if (player->get_round() == 0) {
-            println("{} is the winner!", player->get_name());
-        } else {
-            println("{}: Round {}", player->get_name(), player->get_round());
-        }
-    }
+void Game::print_scores() {
+    events.on_final_scores(players);
 }
 
-Game::~Game() {
-    for (auto* player : players) {
-        delete player;
-    }
-}
\ No newline at end of file
+std::span<Player const> Game::get_players() const noexcept {
+    return players;
+}
+
+CardTracker const& Game::get_tracker() const noexcept {
+    return tracker;
+}
+
+Deck const& Game::get_deck() const noexcept {
+    return deck;
+}
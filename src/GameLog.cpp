@@ -0,0 +1,288 @@
+/**
+ * @file GameLog.cpp
+ * @brief Implementation of the binary game log.
+ */
+
+#include "GameLog.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+#include "Player.h"
+
+namespace {
+
+constexpr std::size_t HEADER_SIZE = LOG_MAGIC.size() + 1;
+
+// A new strategy needs a kind in encode_strategy and decode_strategy
+static_assert(std::variant_size_v<Strategy> == 4);
+
+void put_number(std::uint8_t* out, std::uint64_t value, std::size_t size) noexcept {
+    for (std::size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint64_t get_number(std::span<std::uint8_t const> bytes) noexcept {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        value |= std::uint64_t { bytes[i] } << (8 * i);
+    }
+    return value;
+}
+
+}
+
+
+std::array<std::uint8_t, MAX_RECORD_SIZE> encode_strategy(std::uint8_t seat, Strategy const& strategy) noexcept {
+    std::array<std::uint8_t, MAX_RECORD_SIZE> payload {};
+    payload[0] = seat;
+    payload[1] = static_cast<std::uint8_t>(strategy.index());
+    if (auto const* search = std::get_if<SearchStrategy>(&strategy)) {
+        put_number(&payload[2], search->threads, 4);
+        put_number(&payload[6], search->rollouts, 4);
+        put_number(&payload[10], static_cast<std::uint64_t>(search->time_budget.count()), 8);
+        put_number(&payload[18], search->seed, 8);
+        put_number(&payload[26], search->get_decisions(), 8);
+    }
+    return payload;
+}
+
+Strategy decode_strategy(std::span<std::uint8_t const> payload) {
+    switch (payload[1]) {
+    case 0:
+        return GreedyStrategy {};
+    case 1:
+        return DrawOnlyStrategy {};
+    case 2: {
+        SearchStrategy search;
+        search.threads = static_cast<unsigned>(get_number(payload.subspan(2, 4)));
+        search.rollouts = static_cast<std::uint32_t>(get_number(payload.subspan(6, 4)));
+        search.time_budget = std::chrono::microseconds(static_cast<std::int64_t>(get_number(payload.subspan(10, 8))));
+        search.seed = get_number(payload.subspan(18, 8));
+        search.set_decisions(get_number(payload.subspan(26, 8)));
+        return search;
+    }
+    case 3:
+        return ExternalStrategy {};
+    default:
+        throw std::runtime_error("Unknown strategy kind " + std::to_string(payload[1]));
+    }
+}
+
+LogWriter::LogWriter() {
+    buffer.reserve(BUFFER_SIZE);
+    buffer.insert(buffer.end(), LOG_MAGIC.begin(), LOG_MAGIC.end());
+    buffer.push_back(LOG_VERSION);
+}
+
+LogWriter::LogWriter(std::string const& path_in)
+    : LogWriter() {
+    path = path_in;
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open log file " + path);
+    }
+}
+
+LogWriter::~LogWriter() noexcept {
+    if (file != nullptr) {
+        flush();
+        std::fclose(file);
+    }
+}
+
+void LogWriter::flush() noexcept {
+    if (file != nullptr && !buffer.empty()) {
+        if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+            write_failed = true;
+        }
+        buffer.clear();
+    }
+}
+
+void LogWriter::close() {
+    if (file == nullptr) {
+        return;
+    }
+    flush();
+    // Closing writes out what the C library still buffers, so it can fail too
+    if (std::fclose(file) != 0) {
+        write_failed = true;
+    }
+    file = nullptr;
+    if (write_failed) {
+        throw std::runtime_error("Cannot write log file " + path + "; the log is incomplete");
+    }
+}
+
+
+void RecordingSink::on_game_setup(std::span<Player const> players, short starting_round, short num_decks) noexcept {
+    first_seat = players.data();
+    for (size_t i = 0; i < players.size() && i < rounds.size(); ++i) {
+        rounds[i] = players[i].get_round();
+    }
+    writer.write(LogEvent::GAME_SETUP, static_cast<std::uint8_t>(players.size()),
+                 static_cast<std::uint8_t>(starting_round));
+    if (num_decks > 1) {
+        writer.write(LogEvent::SHOE, static_cast<std::uint8_t>(num_decks));
+    }
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (!std::holds_alternative<GreedyStrategy>(players[i].get_strategy())) {
+            writer.write(LogEvent::STRATEGY, encode_strategy(static_cast<std::uint8_t>(i), players[i].get_strategy()));
+        }
+    }
+}
+
+void RecordingSink::on_deal(Player const& player, Card const& card) noexcept {
+    writer.write(LogEvent::DEAL, seat_of(player), card.get_bits());
+}
+
+void RecordingSink::on_first_discard(Card const& card) noexcept {
+    writer.write(LogEvent::FIRST_DISCARD, card.get_bits());
+}
+
+void RecordingSink::on_turn(Player const& player) noexcept {
+    writer.write(LogEvent::TURN, seat_of(player));
+}
+
+void RecordingSink::on_take_discard(Player const&, Card const& card) noexcept {
+    writer.write(LogEvent::TAKE_DISCARD, card.get_bits());
+}
+
+void RecordingSink::on_draw(Player const&, Card const& card) noexcept {
+    writer.write(LogEvent::DRAW, card.get_bits());
+}
+
+void RecordingSink::on_card_played(Card const& card, Card const& replaced) noexcept {
+    writer.write(LogEvent::PLAY, card.get_bits(), replaced.get_bits());
+}
+
+void RecordingSink::on_discard(Player const&, Card const& card) noexcept {
+    writer.write(LogEvent::DISCARD, card.get_bits());
+}
+
+void RecordingSink::on_stalemate() noexcept {
+    writer.write(LogEvent::STALEMATE);
+}
+
+void RecordingSink::on_round_over(std::span<Player const> players) noexcept {
+    record_round_end(players);
+}
+
+void RecordingSink::on_game_over(std::span<Player const> players) noexcept {
+    record_round_end(players);
+}
+
+void RecordingSink::on_final_scores(std::span<Player const>) noexcept {
+    writer.write(LogEvent::GAME_END);
+}
+
+std::uint8_t RecordingSink::seat_of(Player const& player) const noexcept {
+    return static_cast<std::uint8_t>(&player - first_seat);
+}
+
+void RecordingSink::record_round_end(std::span<Player const> players) noexcept {
+    for (size_t i = 0; i < players.size() && i < rounds.size(); ++i) {
+        if (players[i].get_round() < rounds[i]) {
+            writer.write(LogEvent::ROUND_WON, static_cast<std::uint8_t>(i));
+        }
+        rounds[i] = players[i].get_round();
+    }
+    writer.write(LogEvent::ROUND_END);
+}
+
+
+MappedLog::MappedLog(std::string const& path)
+    : file(path, MappedFile::Access::SEQUENTIAL) {
+    std::span<std::uint8_t const> const bytes = file.bytes();
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), LOG_MAGIC.data(), LOG_MAGIC.size()) != 0
+        || bytes[LOG_MAGIC.size()] != LOG_VERSION) {
+        throw std::runtime_error(path + " is not a game log of version " + std::to_string(LOG_VERSION));
+    }
+}
+
+std::span<std::uint8_t const> MappedLog::records() const noexcept {
+    return file.bytes().subspan(HEADER_SIZE);
+}
+
+
+bool find_recorded_game(std::span<std::uint8_t const> records, std::size_t index, RecordedGame& game) {
+    LogCursor cursor(records);
+    LogRecord record;
+    std::size_t games_seen = 0;
+    std::size_t begin = 0;
+    bool in_game = false;
+    bool external_turn = false;
+
+    game.deck_order.clear();
+    game.strategies.clear();
+    game.external_decisions.clear();
+    for (std::size_t offset = 0; cursor.next(record); offset = cursor.offset()) {
+        if (record.event == LogEvent::GAME_SETUP) {
+            in_game = games_seen == index;
+            if (in_game) {
+                begin = offset;
+                game.num_players = record.a;
+                game.starting_round = record.b;
+                game.num_decks = 1;
+                game.strategies.assign(record.a, GreedyStrategy {});
+            }
+            ++games_seen;
+            continue;
+        }
+        if (!in_game) {
+            continue;
+        }
+        switch (record.event) {
+        case LogEvent::SHOE:
+            game.num_decks = record.a;
+            break;
+        case LogEvent::STRATEGY:
+            if (record.a >= game.strategies.size()) {
+                throw std::runtime_error("Game " + std::to_string(index) + " of the log has a strategy for seat "
+                                         + std::to_string(record.a) + " of " + std::to_string(game.num_players));
+            }
+            game.strategies[record.a] = decode_strategy(record.payload);
+            break;
+        case LogEvent::TURN:
+            external_turn = record.a < game.strategies.size()
+                && std::holds_alternative<ExternalStrategy>(game.strategies[record.a]);
+            break;
+        case LogEvent::TAKE_DISCARD:
+            if (external_turn) {
+                game.external_decisions.push_back(true);
+            }
+            break;
+        case LogEvent::DEAL:
+            game.deck_order.push_back(Card::from_bits(record.b));
+            break;
+        case LogEvent::FIRST_DISCARD:
+            game.deck_order.push_back(Card::from_bits(record.a));
+            break;
+        case LogEvent::DRAW:
+            if (external_turn) {
+                game.external_decisions.push_back(false);
+            }
+            game.deck_order.push_back(Card::from_bits(record.a));
+            break;
+        case LogEvent::GAME_END:
+            if (game.num_players < 1 || game.num_players > Config::MAX_PLAYER_COUNT || game.starting_round < 1
+                || game.starting_round > Config::MAX_STARTING_ROUND || game.num_decks < 1
+                || game.num_decks > Config::MAX_DECKS) {
+                throw std::runtime_error("Game " + std::to_string(index) + " of the log has "
+                                         + std::to_string(game.num_players) + " players, starting round "
+                                         + std::to_string(game.starting_round) + " and "
+                                         + std::to_string(game.num_decks) + " decks");
+            }
+            game.records = records.subspan(begin, cursor.offset() - begin);
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
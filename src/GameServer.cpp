@@ -0,0 +1,473 @@
+/**
+ * @file GameServer.cpp
+ * @brief Implementation of the game server: one epoll event loop per thread, each owning the sessions it accepts.
+ */
+
+#include "GameServer.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <generator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "EventSink.h"
+#include "Game.h"
+#include "Player.h"
+#include "Protocol.h"
+#include "Random.h"
+
+namespace {
+
+/**
+ * @brief epoll keys of the listening socket and the stop event; sessions are keyed by generation and slot.
+ */
+constexpr std::uint64_t LISTEN_KEY = ~std::uint64_t { 0 };
+constexpr std::uint64_t STOP_KEY = LISTEN_KEY - 1;
+
+constexpr int MAX_EVENTS = 256;
+
+/**
+ * @brief One connection and the game it is playing, if any.
+ */
+struct Session {
+    int fd = -1;
+
+    /**
+     * @brief Bumped every time the slot is reused, so events still queued for a closed session are dropped.
+     */
+    std::uint32_t generation = 0;
+
+    // Declared in this order so the iterator goes before its generator and the generator before its game
+    std::optional<Game> game;
+    std::optional<std::generator<GameStep>> steps;
+    std::optional<std::ranges::iterator_t<std::generator<GameStep>>> step;
+    bool awaiting_decision = false;
+
+    std::array<std::uint8_t, 2 * Protocol::MAX_FRAME_SIZE> input;
+    std::size_t input_size = 0;
+    std::array<std::uint8_t, 2 * Protocol::MAX_FRAME_SIZE> output;
+    std::size_t output_size = 0;
+    std::size_t output_sent = 0;
+    bool watching_output = false;
+
+    /**
+     * @brief Close once the output is sent, after an error.
+     */
+    bool closing = false;
+};
+
+}
+
+/**
+ * @brief The sessions of one thread and the epoll instance that watches them.
+ */
+class EventLoop {
+public:
+    explicit EventLoop(GameServer& server_in)
+        : server(server_in)
+        , epoll_fd(::epoll_create1(EPOLL_CLOEXEC))
+        , rng((static_cast<std::uint64_t>(std::random_device {}()) << 32) ^ std::random_device {}()) {
+        if (epoll_fd < 0) {
+            throw std::runtime_error(std::string("Cannot create an epoll instance: ") + std::strerror(errno));
+        }
+        // EPOLLEXCLUSIVE wakes one loop per new connection rather than all of them
+        watch(server.listen_fd, EPOLLIN | EPOLLEXCLUSIVE, LISTEN_KEY);
+        watch(server.stop_fd, EPOLLIN, STOP_KEY);
+    }
+
+    EventLoop(EventLoop const&) = delete;
+    EventLoop& operator=(EventLoop const&) = delete;
+
+    ~EventLoop() noexcept {
+        for (std::uint32_t slot = 0; slot < sessions.size(); ++slot) {
+            if (sessions[slot]) {
+                close_session(slot);
+            }
+        }
+        ::close(epoll_fd);
+    }
+
+    void run() {
+        std::array<epoll_event, MAX_EVENTS> events;
+        for (;;) {
+            int const count = ::epoll_wait(epoll_fd, events.data(), MAX_EVENTS, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("epoll_wait failed: ") + std::strerror(errno));
+            }
+            for (int i = 0; i < count; ++i) {
+                std::uint64_t const key = events[i].data.u64;
+                if (key == STOP_KEY) {
+                    return;
+                }
+                if (key == LISTEN_KEY) {
+                    accept_all();
+                    continue;
+                }
+                auto const slot = static_cast<std::uint32_t>(key);
+                if (slot >= sessions.size() || !sessions[slot] || sessions[slot]->generation != key >> 32) {
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    flush(slot);
+                }
+                if (sessions[slot] && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                    receive(slot);
+                }
+            }
+        }
+    }
+
+private:
+    void watch(int fd, std::uint32_t events, std::uint64_t key) {
+        epoll_event event {};
+        event.events = events;
+        event.data.u64 = key;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            throw std::runtime_error(std::string("Cannot watch a socket: ") + std::strerror(errno));
+        }
+    }
+
+    static std::uint64_t key_of(Session const& session, std::uint32_t slot) noexcept {
+        return (static_cast<std::uint64_t>(session.generation) << 32) | slot;
+    }
+
+    void accept_all() {
+        for (;;) {
+            int const fd = ::accept4(server.listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                // EAGAIN: another loop took it or there is nothing left; anything else is the client's problem
+                return;
+            }
+            if (server.sessions_open.load(std::memory_order_relaxed) >= server.config.max_sessions) {
+                std::array<std::uint8_t, Protocol::MAX_FRAME_SIZE> frame;
+                std::size_t const size = Protocol::write_error(frame, Protocol::Error::SERVER_FULL);
+                [[maybe_unused]] ssize_t const sent = ::send(fd, frame.data(), size, MSG_NOSIGNAL | MSG_DONTWAIT);
+                ::close(fd);
+                continue;
+            }
+
+            std::uint32_t slot;
+            if (free_slots.empty()) {
+                slot = static_cast<std::uint32_t>(sessions.size());
+                sessions.emplace_back();
+                generations.push_back(0);
+            } else {
+                slot = free_slots.back();
+                free_slots.pop_back();
+            }
+            sessions[slot] = std::make_unique<Session>();
+            Session& session = *sessions[slot];
+            session.fd = fd;
+            session.generation = ++generations[slot];
+            epoll_event event {};
+            event.events = EPOLLIN;
+            event.data.u64 = key_of(session, slot);
+            if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+                close_session(slot);
+                continue;
+            }
+            server.sessions_opened.fetch_add(1, std::memory_order_relaxed);
+            server.sessions_open.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void close_session(std::uint32_t slot) noexcept {
+        Session& session = *sessions[slot];
+        ::close(session.fd);
+        sessions[slot].reset();
+        free_slots.push_back(slot);
+        server.sessions_open.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void receive(std::uint32_t slot) {
+        Session& session = *sessions[slot];
+        for (;;) {
+            ssize_t const received = ::recv(session.fd, session.input.data() + session.input_size,
+                                            session.input.size() - session.input_size, 0);
+            if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                close_session(slot);
+                return;
+            }
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            session.input_size += static_cast<std::size_t>(received);
+
+            std::size_t consumed = 0;
+            try {
+                while (std::optional<Protocol::Frame> const frame = Protocol::parse_frame(
+                           std::span(session.input).first(session.input_size).subspan(consumed))) {
+                    consumed += frame->size;
+                    handle(session, *frame);
+                    if (session.closing) {
+                        break;
+                    }
+                }
+            } catch (std::runtime_error const&) {
+                fail(session, Protocol::Error::BAD_MESSAGE);
+            }
+            if (session.closing) {
+                flush(slot);
+                return;
+            }
+            std::ranges::copy(std::span(session.input).first(session.input_size).subspan(consumed),
+                              session.input.begin());
+            session.input_size -= consumed;
+            flush(slot);
+            if (!sessions[slot]) {
+                return;
+            }
+        }
+    }
+
+    void handle(Session& session, Protocol::Frame const& frame) {
+        switch (frame.message) {
+        case Protocol::Message::HELLO:
+            start_game(session, Protocol::read_hello(frame));
+            break;
+        case Protocol::Message::DECIDE: {
+            bool const take_discard = Protocol::read_decide(frame);
+            if (!session.awaiting_decision) {
+                fail(session, Protocol::Error::UNEXPECTED);
+                return;
+            }
+            session.awaiting_decision = false;
+            session.game->decide(take_discard);
+            server.decisions.fetch_add(1, std::memory_order_relaxed);
+            ++*session.step;
+            advance(session);
+            break;
+        }
+        default:
+            fail(session, Protocol::Error::BAD_MESSAGE);
+        }
+    }
+
+    void start_game(Session& session, Protocol::Hello const& hello) {
+        if (session.step) {
+            fail(session, Protocol::Error::UNEXPECTED);
+            return;
+        }
+        if (hello.version != Protocol::VERSION) {
+            fail(session, Protocol::Error::BAD_VERSION);
+            return;
+        }
+        if (hello.num_players < 1 || hello.num_players > Config::MAX_PLAYER_COUNT || hello.starting_round < 1
+            || hello.starting_round > Config::MAX_STARTING_ROUND
+            || Game::min_decks(hello.num_players, hello.starting_round) > Config::MAX_DECKS) {
+            fail(session, Protocol::Error::BAD_TABLE);
+            return;
+        }
+
+        auto const starting_round = static_cast<short>(hello.starting_round);
+        std::vector<Player> players;
+        players.reserve(hello.num_players);
+        players.push_back(Player_factory("Client", starting_round, ExternalStrategy {}));
+        for (std::uint8_t i = 1; i < hello.num_players; ++i) {
+            players.push_back(Player_factory("Player " + std::to_string(i + 1), starting_round));
+        }
+        session.step.reset();
+        session.steps.reset();
+        session.game.emplace(std::move(players), starting_round, true, sink, hello.seed != 0 ? hello.seed : rng());
+        session.steps.emplace(session.game->steps());
+        session.step.emplace(session.steps->begin());
+        server.games_started.fetch_add(1, std::memory_order_relaxed);
+        advance(session);
+    }
+
+    /**
+     * @brief Plays the server's turns until the client has to decide or the game is over, and tells the client.
+     */
+    void advance(Session& session) {
+        for (;; ++*session.step) {
+            GameStep const step = **session.step;
+            if (step.kind == GameStep::Kind::DECISION) {
+                Player const& player = session.game->get_players()[step.seat];
+                Protocol::Decision const decision { static_cast<std::uint8_t>(player.get_round()),
+                                                    session.game->get_deck().peek_discard(), player.get_hand() };
+                session.output_size += Protocol::write_decision(output_space(session), decision);
+                session.awaiting_decision = true;
+                return;
+            }
+            if (step.kind == GameStep::Kind::GAME_OVER) {
+                Protocol::GameOver game_over;
+                std::span<Player const> const players = session.game->get_players();
+                game_over.num_players = static_cast<std::uint8_t>(players.size());
+                for (std::size_t i = 0; i < players.size(); ++i) {
+                    game_over.rounds[i] = static_cast<std::uint8_t>(players[i].get_round());
+                }
+                session.output_size += Protocol::write_game_over(output_space(session), game_over);
+                session.step.reset();
+                session.steps.reset();
+                session.game.reset();
+                server.games_finished.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Room for one more frame at the end of the output. A client that lets two frames pile up has stopped
+     * reading, since it only ever gets a frame in answer to one of its own.
+     */
+    static std::span<std::uint8_t> output_space(Session& session) {
+        if (session.output.size() - session.output_size < Protocol::MAX_FRAME_SIZE) {
+            throw std::runtime_error("The client does not read its messages");
+        }
+        return std::span(session.output).subspan(session.output_size);
+    }
+
+    void fail(Session& session, Protocol::Error error) noexcept {
+        session.awaiting_decision = false;
+        if (session.output.size() - session.output_size >= Protocol::MAX_FRAME_SIZE) {
+            session.output_size += Protocol::write_error(std::span(session.output).subspan(session.output_size), error);
+        }
+        session.closing = true;
+    }
+
+    /**
+     * @brief Sends what it can of the output, and watches for room in the socket while anything is left.
+     */
+    void flush(std::uint32_t slot) {
+        Session& session = *sessions[slot];
+        while (session.output_sent < session.output_size) {
+            ssize_t const sent = ::send(session.fd, session.output.data() + session.output_sent,
+                                        session.output_size - session.output_sent, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    set_watching_output(session, slot, true);
+                    return;
+                }
+                close_session(slot);
+                return;
+            }
+            session.output_sent += static_cast<std::size_t>(sent);
+        }
+        session.output_size = 0;
+        session.output_sent = 0;
+        if (session.closing) {
+            close_session(slot);
+            return;
+        }
+        set_watching_output(session, slot, false);
+    }
+
+    void set_watching_output(Session& session, std::uint32_t slot, bool watching) noexcept {
+        if (session.watching_output == watching) {
+            return;
+        }
+        epoll_event event {};
+        event.events = watching ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        event.data.u64 = key_of(session, slot);
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session.fd, &event);
+        session.watching_output = watching;
+    }
+
+    GameServer& server;
+    int epoll_fd;
+    NullSink sink;
+    Rng rng;
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> free_slots;
+};
+
+GameServer::GameServer(ServerConfig config_in)
+    : config(std::move(config_in)) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (config.socket_path.empty() || config.socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("The socket path must have between 1 and "
+                                 + std::to_string(sizeof(address.sun_path) - 1) + " characters");
+    }
+    std::ranges::copy(config.socket_path, address.sun_path);
+
+    // A socket left behind by a server that did not shut down cleanly would make bind fail
+    struct stat info;
+    if (::stat(config.socket_path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error(config.socket_path + " exists and is not a socket");
+        }
+        ::unlink(config.socket_path.c_str());
+    }
+
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error(std::string("Cannot create a socket: ") + std::strerror(errno));
+    }
+    if (::bind(listen_fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0
+        || ::listen(listen_fd, SOMAXCONN) != 0) {
+        std::string const reason = std::strerror(errno);
+        ::close(listen_fd);
+        throw std::runtime_error("Cannot listen on " + config.socket_path + ": " + reason);
+    }
+    stop_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_fd < 0) {
+        std::string const reason = std::strerror(errno);
+        ::close(listen_fd);
+        ::unlink(config.socket_path.c_str());
+        throw std::runtime_error("Cannot create an eventfd: " + reason);
+    }
+}
+
+GameServer::~GameServer() noexcept {
+    ::close(stop_fd);
+    ::close(listen_fd);
+    ::unlink(config.socket_path.c_str());
+}
+
+void GameServer::run() {
+    unsigned num_threads = config.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Set every loop up before serving, so a failure is reported here rather than from a thread
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        loops.push_back(std::make_unique<EventLoop>(*this));
+    }
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned t = 1; t < num_threads; ++t) {
+            workers.emplace_back([&, t] { loops[t]->run(); });
+        }
+        loops[0]->run();
+    }
+}
+
+void GameServer::stop() noexcept {
+    std::uint64_t const one = 1;
+    [[maybe_unused]] ssize_t const written = ::write(stop_fd, &one, sizeof(one));
+}
+
+ServerStats GameServer::get_stats() const noexcept {
+    return { sessions_opened.load(std::memory_order_relaxed), sessions_open.load(std::memory_order_relaxed),
+             games_started.load(std::memory_order_relaxed), games_finished.load(std::memory_order_relaxed),
+             decisions.load(std::memory_order_relaxed) };
+}
@@ -0,0 +1,150 @@
+/**
+ * @file GameSnapshot.cpp
+ * @brief Implementation of the snapshot file format.
+ */
+
+#include "GameSnapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "MappedFile.h"
+
+namespace {
+
+constexpr std::uint32_t SNAPSHOT_SIZE = sizeof(GameSnapshot);
+
+bool valid_card(Card const& card) noexcept {
+    auto const rank = static_cast<int>(card.get_rank());
+    return rank >= 1 && rank <= NUM_RANKS;
+}
+
+bool valid_cards(std::span<Card const> cards) noexcept {
+    return std::ranges::all_of(cards, valid_card);
+}
+
+/**
+ * @brief Checks that a snapshot read from outside describes a state the engine can carry on from without reading out
+ * of bounds: the piles and hands fit the shoe, the card tracker accounts for every card of it, and the round in
+ * progress is at a seat of the table. Cards face up can only have grown since the last reshuffle.
+ */
+bool valid_snapshot(GameSnapshot const& snapshot) noexcept {
+    if (snapshot.num_players < 1 || snapshot.num_players > Config::MAX_PLAYER_COUNT || snapshot.starting_round < 1
+        || snapshot.starting_round > Config::MAX_STARTING_ROUND) {
+        return false;
+    }
+
+    Deck::Snapshot const& deck = snapshot.deck;
+    if (deck.num_decks < 1 || deck.num_decks > Config::MAX_DECKS
+        || deck.shoe_size != deck.num_decks * Deck::CARDS_PER_DECK || deck.draw_begin >= deck.shoe_size
+        || deck.draw_count + deck.discard_count > deck.shoe_size || deck.unshuffled_count > deck.draw_count
+        || deck.shuffle_mode > Deck::ShuffleMode::LAZY
+        || !valid_cards(std::span(deck.cards).first(deck.shoe_size))) {
+        return false;
+    }
+
+    // Every card of the shoe is unseen, in the discard pile or face up in a hand, so each rank adds up to its copies
+    std::array<int, NUM_RANKS + 1> seen_face_up {};
+    std::size_t face_up = 0;
+    for (short p = 0; p < snapshot.num_players; ++p) {
+        Hand const& hand = snapshot.hands[p];
+        if (hand.size() > static_cast<std::size_t>(Config::MAX_STARTING_ROUND) || !valid_cards(hand.get_cards())
+            || (hand.get_showing_mask() >> hand.size()) != 0 || snapshot.rounds[p] < 0
+            || snapshot.rounds[p] > snapshot.starting_round) {
+            return false;
+        }
+        for (std::size_t i = 0; i < hand.size(); ++i) {
+            if (hand.is_showing(i)) {
+                ++seen_face_up[static_cast<std::size_t>(hand.get_card(i).get_rank())];
+                ++face_up;
+            }
+        }
+    }
+
+    CardTracker::Snapshot const& tracker = snapshot.tracker;
+    if (tracker.num_decks != deck.num_decks || tracker.discard_size > Deck::MAX_SHOE_SIZE
+        || !valid_cards(std::span(tracker.discard_pile).first(tracker.discard_size))
+        || tracker.unseen_by_rank[0] != 0 || tracker.discarded_by_rank[0] != 0) {
+        return false;
+    }
+    std::array<int, NUM_RANKS + 1> in_discard_pile {};
+    for (Card const& card : std::span(tracker.discard_pile).first(tracker.discard_size)) {
+        ++in_discard_pile[static_cast<std::size_t>(card.get_rank())];
+    }
+    int unseen = 0;
+    for (std::size_t rank = 1; rank <= NUM_RANKS; ++rank) {
+        if (tracker.discarded_by_rank[rank] != in_discard_pile[rank]
+            || tracker.unseen_by_rank[rank] + tracker.discarded_by_rank[rank] + seen_face_up[rank]
+                   != NUM_SUITS * deck.num_decks) {
+            return false;
+        }
+        unseen += tracker.unseen_by_rank[rank];
+    }
+    if (unseen != tracker.unseen_count) {
+        return false;
+    }
+
+    return snapshot.seat < snapshot.num_players && (snapshot.completed >> snapshot.num_players) == 0
+           && snapshot.idle_reshuffles >= 0 && snapshot.idle_reshuffles <= Config::MAX_IDLE_RESHUFFLES
+           && snapshot.face_up <= face_up;
+}
+
+}
+
+std::vector<std::uint8_t> serialize_snapshot(GameSnapshot const& snapshot) {
+    std::vector<std::uint8_t> bytes(SNAPSHOT_HEADER_SIZE + SNAPSHOT_SIZE);
+    std::memcpy(bytes.data(), SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size());
+    bytes[SNAPSHOT_MAGIC.size()] = SNAPSHOT_VERSION;
+    std::memcpy(bytes.data() + SNAPSHOT_MAGIC.size() + 1, &SNAPSHOT_SIZE, sizeof(SNAPSHOT_SIZE));
+    std::memcpy(bytes.data() + SNAPSHOT_HEADER_SIZE, &snapshot, SNAPSHOT_SIZE);
+    return bytes;
+}
+
+GameSnapshot deserialize_snapshot(std::span<std::uint8_t const> bytes) {
+    std::uint32_t size = 0;
+    if (bytes.size() >= SNAPSHOT_HEADER_SIZE) {
+        std::memcpy(&size, bytes.data() + SNAPSHOT_MAGIC.size() + 1, sizeof(size));
+    }
+    if (bytes.size() < SNAPSHOT_HEADER_SIZE
+        || std::memcmp(bytes.data(), SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size()) != 0
+        || bytes[SNAPSHOT_MAGIC.size()] != SNAPSHOT_VERSION || size != SNAPSHOT_SIZE
+        || bytes.size() != SNAPSHOT_HEADER_SIZE + SNAPSHOT_SIZE) {
+        throw std::runtime_error("Not a game snapshot of version " + std::to_string(SNAPSHOT_VERSION)
+                                 + " and this build's layout");
+    }
+
+    GameSnapshot snapshot {};
+    std::memcpy(&snapshot, bytes.data() + SNAPSHOT_HEADER_SIZE, SNAPSHOT_SIZE);
+    if (!valid_snapshot(snapshot)) {
+        throw std::runtime_error("The game snapshot describes an impossible state");
+    }
+    return snapshot;
+}
+
+void write_snapshot(std::string const& path, GameSnapshot const& snapshot) {
+    // Write next to the target and rename over it, so an interrupted checkpoint never leaves a torn file behind
+    std::string const temporary = path + ".tmp";
+    std::vector<std::uint8_t> const bytes = serialize_snapshot(snapshot);
+    {
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(temporary.c_str(), "wb"), &std::fclose);
+        if (!file || std::fwrite(bytes.data(), 1, bytes.size(), file.get()) != bytes.size()
+            || std::fflush(file.get()) != 0) {
+            throw std::runtime_error("Cannot write snapshot file " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace snapshot file " + path);
+    }
+}
+
+GameSnapshot read_snapshot(std::string const& path) {
+    MappedFile const file(path, MappedFile::Access::SEQUENTIAL);
+    try {
+        return deserialize_snapshot(file.bytes());
+    } catch (std::runtime_error const& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
@@ -0,0 +1,488 @@
+/**
+ * @file LockstepEngine.cpp
+ * @brief Implementation of the lockstep engine and its scalar and AVX2 turn kernels.
+ */
+
+#include "LockstepEngine.h"
+
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+#include "Deck.h"
+#include "Random.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int RANK_MASK = 0x0F;
+
+}
+
+LockstepEngine::Kernel LockstepEngine::best_kernel() noexcept {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::AVX2;
+    }
+#endif
+    return Kernel::SCALAR;
+}
+
+LockstepEngine::LockstepEngine(short num_players_in, short starting_round_in, std::uint64_t master_seed_in,
+                               std::size_t lanes_in, Kernel kernel_in)
+    : num_players(num_players_in)
+    , starting_round(starting_round_in)
+    , master_seed(master_seed_in)
+    , lanes(lanes_in)
+    , kernel(kernel_in == Kernel::AVX2 && best_kernel() != Kernel::AVX2 ? Kernel::SCALAR : kernel_in) {
+    if (num_players < 1 || num_players > Config::MAX_PLAYER_COUNT) {
+        throw std::invalid_argument("num_players must be between 1 and " + std::to_string(Config::MAX_PLAYER_COUNT));
+    }
+    if (starting_round < 1 || starting_round > Config::MAX_STARTING_ROUND) {
+        throw std::invalid_argument("starting_round must be between 1 and "
+                                    + std::to_string(Config::MAX_STARTING_ROUND));
+    }
+    if (num_players * starting_round + 1 > DECK_SIZE) {
+        throw std::invalid_argument("the lockstep engine deals from a single deck of " + std::to_string(DECK_SIZE)
+                                    + " cards");
+    }
+    if (lanes < 8 || lanes > 32 || lanes % 8 != 0) {
+        throw std::invalid_argument("lanes must be a multiple of 8 between 8 and 32");
+    }
+
+    // Idle lanes are all zeros, which the kernels can step through harmlessly
+    cards.assign(DECK_SIZE * lanes, 0);
+    hands.assign(static_cast<std::size_t>(num_players) * HAND_SLOTS * lanes, 0);
+    for (auto* per_seat : { &showing, &hand_size, &rounds_left }) {
+        per_seat->assign(static_cast<std::size_t>(num_players) * lanes, 0);
+    }
+    for (auto* per_lane : { &active, &draw_begin, &draw_count, &discard_count, &unshuffled_count, &seat, &won,
+                            &face_up, &idle_reshuffles, &turns, &rounds, &reshuffles, &stalemates }) {
+        per_lane->assign(lanes, 0);
+    }
+    game_index.assign(lanes, 0);
+    for (auto& word : rng_state) {
+        word.assign(lanes, 0);
+    }
+}
+
+void LockstepEngine::start_game(std::size_t lane, std::uint64_t index) noexcept {
+    Rng const rng(stream_seed(master_seed, index));
+    for (std::size_t w = 0; w < rng_state.size(); ++w) {
+        rng_state[w][lane] = rng.get_state()[w];
+    }
+    game_index[lane] = index;
+    turns[lane] = 0;
+    rounds[lane] = 0;
+    reshuffles[lane] = 0;
+    stalemates[lane] = 0;
+    for (int p = 0; p < num_players; ++p) {
+        rounds_left[seat_index(p, lane)] = starting_round;
+    }
+    if (active[lane] == 0) {
+        active[lane] = -1;
+        ++active_count;
+    }
+    start_round(lane);
+}
+
+void LockstepEngine::start_round(std::size_t lane) noexcept {
+    // Deck::redeal followed by Deck::shuffle in lazy mode
+    std::array<Card, NUM_SUITS * NUM_RANKS> const& order = Deck::standard_order();
+    for (int slot = 0; slot < DECK_SIZE; ++slot) {
+        card(slot, lane) = order[slot].get_bits();
+    }
+    draw_begin[lane] = 0;
+    draw_count[lane] = DECK_SIZE;
+    discard_count[lane] = 0;
+    unshuffled_count[lane] = DECK_SIZE;
+
+    for (int p = 0; p < num_players; ++p) {
+        std::size_t const si = seat_index(p, lane);
+        hand_size[si] = rounds_left[si];
+        showing[si] = 0;
+        for (int position = 0; position < hand_size[si]; ++position) {
+            hand(p, position, lane) = deal_one(lane);
+        }
+    }
+    int const first_card = deal_one(lane);
+    ++discard_count[lane];
+    card(wrap(draw_begin[lane] - discard_count[lane]), lane) = first_card;
+
+    won[lane] = 0;
+    seat[lane] = 0;
+    face_up[lane] = 0;
+    idle_reshuffles[lane] = 0;
+}
+
+int LockstepEngine::deal_one(std::size_t lane) noexcept {
+    int const begin = draw_begin[lane];
+    int& count = draw_count[lane];
+    if (unshuffled_count[lane] > 0) {
+        std::array<std::uint64_t, 4> state;
+        for (std::size_t w = 0; w < state.size(); ++w) {
+            state[w] = rng_state[w][lane];
+        }
+        Rng rng(state);
+        int const top = count - 1;
+        int const pick = top - static_cast<int>(random_below(rng, static_cast<std::uint32_t>(unshuffled_count[lane])));
+        for (std::size_t w = 0; w < state.size(); ++w) {
+            rng_state[w][lane] = rng.get_state()[w];
+        }
+        std::swap(card(wrap(begin + top), lane), card(wrap(begin + pick), lane));
+        --unshuffled_count[lane];
+    }
+    --count;
+    return card(wrap(begin + count), lane);
+}
+
+int LockstepEngine::count_face_up(std::size_t lane) const noexcept {
+    int total = 0;
+    for (int p = 0; p < num_players; ++p) {
+        total += std::popcount(static_cast<unsigned>(showing[seat_index(p, lane)]));
+    }
+    return total;
+}
+
+bool LockstepEngine::turn(std::size_t lane) noexcept {
+    int const s = seat[lane];
+    std::size_t const si = seat_index(s, lane);
+    int const full = (1 << hand_size[si]) - 1;
+    int open = full & ~showing[si];
+    auto const playable = [&](int c) { return ((open >> ((c & RANK_MASK) - 1)) & 1) != 0; };
+
+    // GreedyStrategy: take the discard whenever it can be placed, otherwise draw
+    int current = card(wrap(draw_begin[lane] - discard_count[lane]), lane);
+    if (playable(current)) {
+        --discard_count[lane];
+    } else {
+        current = deal_one(lane);
+    }
+
+    // Hand::play_card
+    while (playable(current)) {
+        int const position = (current & RANK_MASK) - 1;
+        int& slot = hand(s, position, lane);
+        int const replaced = slot;
+        slot = current;
+        open &= ~(1 << position);
+        current = replaced;
+    }
+
+    ++discard_count[lane];
+    card(wrap(draw_begin[lane] - discard_count[lane]), lane) = current;
+    showing[si] = full & ~open;
+    if (open == 0) {
+        won[lane] |= 1 << s;
+    }
+    ++turns[lane];
+    if (++seat[lane] == num_players) {
+        seat[lane] = 0;
+        if (won[lane] != 0) {
+            return true;
+        }
+    }
+    return draw_count[lane] == 0;
+}
+
+bool LockstepEngine::settle(std::size_t lane) noexcept {
+    bool round_over = seat[lane] == 0 && won[lane] != 0;
+    if (!round_over) {
+        // The deck is empty: the stalemate check and reshuffle of Game::take_turns
+        int const now_face_up = count_face_up(lane);
+        if (now_face_up != face_up[lane]) {
+            face_up[lane] = now_face_up;
+            idle_reshuffles[lane] = 0;
+        } else if (++idle_reshuffles[lane] > Config::MAX_IDLE_RESHUFFLES) {
+            ++stalemates[lane];
+            round_over = true;
+        }
+    }
+    if (!round_over) {
+        if (discard_count[lane] > 0) {
+            // Deck::reset: the recycled discards are turned over so the most recent one is dealt first
+            int const recycled = discard_count[lane] - 1;
+            for (int low = -recycled, high = -1; low < high; ++low, --high) {
+                std::swap(card(wrap(draw_begin[lane] + low), lane), card(wrap(draw_begin[lane] + high), lane));
+            }
+            draw_begin[lane] = wrap(draw_begin[lane] - recycled);
+            draw_count[lane] += recycled;
+            discard_count[lane] = 1;
+        }
+        unshuffled_count[lane] = draw_count[lane];
+        ++reshuffles[lane];
+        return true;
+    }
+
+    // Game::play_round
+    ++rounds[lane];
+    bool game_over = false;
+    for (int p = 0; p < num_players; ++p) {
+        int& left = rounds_left[seat_index(p, lane)];
+        if (((won[lane] >> p) & 1) != 0 && left > 0) {
+            --left;
+        }
+        game_over = game_over || left == 0;
+    }
+    if (game_over) {
+        return false;
+    }
+    start_round(lane);
+    return true;
+}
+
+LockstepGame LockstepEngine::result(std::size_t lane) const noexcept {
+    LockstepGame game;
+    game.index = game_index[lane];
+    game.rounds = static_cast<std::uint32_t>(rounds[lane]);
+    game.turns = static_cast<std::uint32_t>(turns[lane]);
+    game.reshuffles = static_cast<std::uint32_t>(reshuffles[lane]);
+    game.stalemates = static_cast<std::uint32_t>(stalemates[lane]);
+    for (int p = 0; p < num_players; ++p) {
+        game.final_rounds[p] = static_cast<short>(rounds_left[seat_index(p, lane)]);
+    }
+    return game;
+}
+
+std::uint32_t LockstepEngine::step() noexcept {
+    return kernel == Kernel::AVX2 ? step_avx2() : step_scalar();
+}
+
+std::uint32_t LockstepEngine::step_scalar() noexcept {
+    std::uint32_t pending = 0;
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        if (active[lane] != 0 && turn(lane)) {
+            pending |= 1u << lane;
+        }
+    }
+    return pending;
+}
+
+#if defined(__x86_64__)
+
+// Everything down to step_avx2 is compiled for AVX2; step() only calls it when the CPU supports it
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace {
+
+using Vec = __m256i;
+
+inline Vec wrap_slots(Vec position) noexcept {
+    Vec const size = _mm256_set1_epi32(52);
+    Vec const below = _mm256_cmpgt_epi32(_mm256_setzero_si256(), position);
+    Vec const above = _mm256_cmpgt_epi32(position, _mm256_set1_epi32(51));
+    return _mm256_sub_epi32(_mm256_add_epi32(position, _mm256_and_si256(below, size)), _mm256_and_si256(above, size));
+}
+
+inline Vec gather(int const* base, Vec index) noexcept {
+    return _mm256_i32gather_epi32(base, index, 4);
+}
+
+/**
+ * @brief Stores value[i] to base[index[i]] for every lane i set in mask. AVX2 has no scatter.
+ */
+inline void scatter(int* base, Vec index, Vec value, Vec mask) noexcept {
+    alignas(32) int indices[8];
+    alignas(32) int values[8];
+    _mm256_store_si256(reinterpret_cast<Vec*>(indices), index);
+    _mm256_store_si256(reinterpret_cast<Vec*>(values), value);
+    for (unsigned m = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))); m != 0; m &= m - 1) {
+        int const i = std::countr_zero(m);
+        base[indices[i]] = values[i];
+    }
+}
+
+inline Vec rotl64(Vec x, int k) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+/**
+ * @brief Four xoshiro256** generators, one per 64-bit lane.
+ */
+struct RngVec {
+    Vec s0, s1, s2, s3;
+
+    Vec next() noexcept {
+        Vec const times5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        Vec const rotated = rotl64(times5, 7);
+        Vec const result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+        Vec const t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = rotl64(s3, 45);
+        return result;
+    }
+};
+
+/**
+ * @brief Packs the low 32 bits of the 64-bit lanes of two vectors into one vector of eight 32-bit lanes.
+ */
+inline Vec pack_low32(Vec low, Vec high) noexcept {
+    Vec const even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    return _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(low, even), _mm256_permutevar8x32_epi32(high, even),
+                                     0x20);
+}
+
+}
+
+std::uint32_t LockstepEngine::step_avx2() noexcept {
+    Vec const zero = _mm256_setzero_si256();
+    Vec const one = _mm256_set1_epi32(1);
+    Vec const rank_mask = _mm256_set1_epi32(RANK_MASK);
+    Vec const stride = _mm256_set1_epi32(static_cast<int>(lanes));
+    Vec const hand_slots = _mm256_set1_epi32(HAND_SLOTS);
+    Vec const players = _mm256_set1_epi32(num_players);
+    Vec const low32 = _mm256_set1_epi64x(0xFFFFFFFF);
+
+    std::uint32_t pending = 0;
+    for (std::size_t base = 0; base < lanes; base += 8) {
+        auto const load = [&](std::vector<int>& v) { return _mm256_loadu_si256(reinterpret_cast<Vec*>(&v[base])); };
+        auto const store = [&](std::vector<int>& v, Vec x) { _mm256_storeu_si256(reinterpret_cast<Vec*>(&v[base]), x); };
+
+        Vec const live = load(active);
+        if (_mm256_testz_si256(live, live)) {
+            continue;
+        }
+        Vec const lane = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(base)),
+                                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        Vec const seat_v = load(seat);
+        Vec const si = _mm256_add_epi32(_mm256_mullo_epi32(seat_v, stride), lane);
+        Vec const full = _mm256_sub_epi32(_mm256_sllv_epi32(one, gather(hand_size.data(), si)), one);
+        Vec open = _mm256_andnot_si256(gather(showing.data(), si), full);
+        auto const playable = [&](Vec c) {
+            Vec const shift = _mm256_sub_epi32(_mm256_and_si256(c, rank_mask), one);
+            return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srlv_epi32(open, shift), one), one);
+        };
+        auto const slot_index = [&](Vec slot) { return _mm256_add_epi32(_mm256_mullo_epi32(slot, stride), lane); };
+
+        // GreedyStrategy: take the discard whenever it can be placed, otherwise draw
+        Vec const begin = load(draw_begin);
+        Vec discards = load(discard_count);
+        Vec const top_discard = gather(cards.data(), slot_index(wrap_slots(_mm256_sub_epi32(begin, discards))));
+        Vec const take = _mm256_and_si256(live, playable(top_discard));
+        Vec const draw = _mm256_andnot_si256(take, live);
+        discards = _mm256_add_epi32(discards, take);
+
+        // Deck::deal_one: one Fisher-Yates step in the lanes that still have unshuffled cards
+        Vec count = load(draw_count);
+        Vec unshuffled = load(unshuffled_count);
+        Vec const shuffling = _mm256_and_si256(draw, _mm256_cmpgt_epi32(unshuffled, zero));
+        Vec offset = zero;
+        if (!_mm256_testz_si256(shuffling, shuffling)) {
+            auto const load64 = [&](std::vector<std::uint64_t>& v, std::size_t at) {
+                return _mm256_loadu_si256(reinterpret_cast<Vec*>(&v[at]));
+            };
+            RngVec halves[2];
+            RngVec old[2];
+            Vec products[2];
+            Vec rejects[2];
+            for (int h = 0; h < 2; ++h) {
+                std::size_t const at = base + 4 * h;
+                old[h] = { load64(rng_state[0], at), load64(rng_state[1], at), load64(rng_state[2], at),
+                           load64(rng_state[3], at) };
+                halves[h] = old[h];
+                Vec const bound = _mm256_cvtepu32_epi64(h == 0 ? _mm256_castsi256_si128(unshuffled)
+                                                               : _mm256_extracti128_si256(unshuffled, 1));
+                // random_below: the high half of one output times the bound, rejecting rare biased products
+                products[h] = _mm256_mul_epu32(_mm256_srli_epi64(halves[h].next(), 32), bound);
+                Vec const low_below = _mm256_cmpgt_epi64(bound, _mm256_and_si256(products[h], low32));
+                Vec const mask = _mm256_cvtepi32_epi64(h == 0 ? _mm256_castsi256_si128(shuffling)
+                                                              : _mm256_extracti128_si256(shuffling, 1));
+                Vec* words[] = { &halves[h].s0, &halves[h].s1, &halves[h].s2, &halves[h].s3 };
+                Vec const* old_words[] = { &old[h].s0, &old[h].s1, &old[h].s2, &old[h].s3 };
+                for (std::size_t w = 0; w < 4; ++w) {
+                    *words[w] = _mm256_blendv_epi8(*old_words[w], *words[w], mask);
+                    _mm256_storeu_si256(reinterpret_cast<Vec*>(&rng_state[w][at]), *words[w]);
+                }
+                rejects[h] = _mm256_and_si256(low_below, mask);
+            }
+            offset = _mm256_and_si256(pack_low32(_mm256_srli_epi64(products[0], 32),
+                                                 _mm256_srli_epi64(products[1], 32)),
+                                      shuffling);
+
+            // A product below the bound may need rejection sampling: redo those lanes with the scalar generator
+            Vec const reject = pack_low32(rejects[0], rejects[1]);
+            if (!_mm256_testz_si256(reject, reject)) {
+                alignas(32) int offsets[8];
+                alignas(32) std::uint64_t old_state[4][8];
+                _mm256_store_si256(reinterpret_cast<Vec*>(offsets), offset);
+                for (int h = 0; h < 2; ++h) {
+                    Vec const* old_words[] = { &old[h].s0, &old[h].s1, &old[h].s2, &old[h].s3 };
+                    for (std::size_t w = 0; w < 4; ++w) {
+                        _mm256_store_si256(reinterpret_cast<Vec*>(&old_state[w][4 * h]), *old_words[w]);
+                    }
+                }
+                for (unsigned m = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(reject))); m != 0;
+                     m &= m - 1) {
+                    int const i = std::countr_zero(m);
+                    Rng rng({ old_state[0][i], old_state[1][i], old_state[2][i], old_state[3][i] });
+                    offsets[i] = static_cast<int>(random_below(rng, static_cast<std::uint32_t>(unshuffled_count[base + i])));
+                    for (std::size_t w = 0; w < 4; ++w) {
+                        rng_state[w][base + i] = rng.get_state()[w];
+                    }
+                }
+                offset = _mm256_load_si256(reinterpret_cast<Vec const*>(offsets));
+            }
+        }
+        Vec const top = _mm256_sub_epi32(count, one);
+        Vec const top_index = slot_index(wrap_slots(_mm256_add_epi32(begin, top)));
+        Vec const pick_index = slot_index(wrap_slots(_mm256_sub_epi32(_mm256_add_epi32(begin, top), offset)));
+        Vec const top_card = gather(cards.data(), top_index);
+        Vec const drawn = gather(cards.data(), pick_index);
+        scatter(cards.data(), pick_index, top_card, shuffling);
+        scatter(cards.data(), top_index, drawn, shuffling);
+        unshuffled = _mm256_add_epi32(unshuffled, shuffling);
+        count = _mm256_add_epi32(count, draw);
+        Vec current = _mm256_blendv_epi8(top_discard, drawn, draw);
+
+        // Hand::play_card, with lanes dropping out as their chains end
+        Vec const hand_base = _mm256_mullo_epi32(seat_v, hand_slots);
+        for (Vec chain = _mm256_and_si256(live, playable(current)); !_mm256_testz_si256(chain, chain);
+             chain = _mm256_and_si256(chain, playable(current))) {
+            Vec const position = _mm256_sub_epi32(_mm256_and_si256(current, rank_mask), one);
+            Vec const hand_index = slot_index(_mm256_add_epi32(hand_base, position));
+            Vec const replaced = _mm256_mask_i32gather_epi32(current, hands.data(), hand_index, chain, 4);
+            scatter(hands.data(), hand_index, current, chain);
+            open = _mm256_andnot_si256(_mm256_and_si256(chain, _mm256_sllv_epi32(one, position)), open);
+            current = _mm256_blendv_epi8(current, replaced, chain);
+        }
+
+        discards = _mm256_sub_epi32(discards, live);
+        scatter(cards.data(), slot_index(wrap_slots(_mm256_sub_epi32(begin, discards))), current, live);
+        scatter(showing.data(), si, _mm256_andnot_si256(open, full), live);
+
+        Vec const completed = _mm256_and_si256(live, _mm256_cmpeq_epi32(open, zero));
+        Vec const won_v = _mm256_or_si256(load(won), _mm256_and_si256(completed, _mm256_sllv_epi32(one, seat_v)));
+        Vec next_seat = _mm256_sub_epi32(seat_v, live);
+        Vec const wrapped = _mm256_and_si256(live, _mm256_cmpeq_epi32(next_seat, players));
+        next_seat = _mm256_andnot_si256(wrapped, next_seat);
+        Vec const round_over = _mm256_andnot_si256(_mm256_cmpeq_epi32(won_v, zero), wrapped);
+        Vec const attention = _mm256_and_si256(live, _mm256_or_si256(round_over, _mm256_cmpeq_epi32(count, zero)));
+
+        store(discard_count, discards);
+        store(draw_count, count);
+        store(unshuffled_count, unshuffled);
+        store(seat, next_seat);
+        store(won, won_v);
+        store(turns, _mm256_sub_epi32(load(turns), live));
+        pending |= static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(attention))) << base;
+    }
+    return pending;
+}
+
+#pragma GCC pop_options
+
+#else
+
+std::uint32_t LockstepEngine::step_avx2() noexcept {
+    return step_scalar();
+}
+
+#endif
@@ -0,0 +1,248 @@
+/**
+ * @file Logger.cpp
+ * @brief Implementation of the asynchronous logger.
+ */
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Longest time text waits in a ring before the writer picks it up.
+ */
+constexpr std::chrono::milliseconds DRAIN_INTERVAL { 1 };
+
+constexpr std::size_t MIN_RING_BYTES = 4096;
+
+std::atomic<std::uint64_t> next_logger_id { 0 };
+
+std::FILE* open_for_writing(std::string const& path) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open " + path + " for logging");
+    }
+    return file;
+}
+
+}
+
+/**
+ * @brief A single-producer, single-consumer byte ring. Positions only grow; the slot of a position is its low bits.
+ */
+struct Logger::Ring {
+    explicit Ring(std::size_t capacity_in)
+        : data(new char[capacity_in])
+        , capacity(capacity_in) {}
+
+    std::unique_ptr<char[]> data;
+    std::size_t capacity;
+
+    /**
+     * @brief Position up to which the writer has taken the text. Written by the writer thread only.
+     */
+    alignas(64) std::atomic<std::uint64_t> taken { 0 };
+
+    /**
+     * @brief Position up to which the owning thread has appended text. Written by the owning thread only.
+     */
+    alignas(64) std::atomic<std::uint64_t> appended { 0 };
+};
+
+Logger::Logger(std::FILE* out_in, Level threshold_in, std::size_t ring_bytes_in)
+    : out(out_in)
+    , threshold(threshold_in)
+    , ring_bytes(std::bit_ceil(std::max(ring_bytes_in, MIN_RING_BYTES)))
+    , id(next_logger_id.fetch_add(1, std::memory_order_relaxed)) {
+    writer = std::jthread([this] { run_writer(); });
+}
+
+Logger::Logger(std::string const& path, Level threshold_in, std::size_t ring_bytes_in)
+    : Logger(open_for_writing(path), threshold_in, ring_bytes_in) {
+    owns_file = true;
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard const lock(mutex);
+        stopping = true;
+    }
+    writer_wakeup.notify_one();
+    writer.join();
+    if (owns_file) {
+        std::fclose(out);
+    }
+}
+
+std::string& Logger::scratch() noexcept {
+    thread_local std::string text;
+    return text;
+}
+
+Logger::Ring& Logger::local_ring() {
+    struct CachedRing {
+        std::uint64_t logger;
+        Ring* ring;
+    };
+    thread_local std::vector<CachedRing> cache;
+    for (CachedRing const& cached : cache) {
+        if (cached.logger == id) {
+            return *cached.ring;
+        }
+    }
+
+    auto ring = std::make_unique<Ring>(ring_bytes);
+    Ring& created = *ring;
+    {
+        std::lock_guard const lock(mutex);
+        rings.push_back(std::move(ring));
+    }
+    cache.push_back({ id, &created });
+    return created;
+}
+
+void Logger::append(std::string_view text) noexcept {
+    Ring* found = nullptr;
+    try {
+        found = &local_ring();
+    } catch (std::bad_alloc const&) {
+        write_failed.store(true, std::memory_order_relaxed);
+        return;
+    }
+    Ring& ring = *found;
+    while (!text.empty()) {
+        std::uint64_t const position = ring.appended.load(std::memory_order_relaxed);
+        std::size_t const free = ring.capacity - (position - ring.taken.load(std::memory_order_acquire));
+        // Keep messages that fit in the ring whole, so threads only interleave at message boundaries
+        if (free == 0 || (free < text.size() && text.size() <= ring.capacity)) {
+            wake();
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::size_t const length = std::min(free, text.size());
+        std::size_t const slot = position & (ring.capacity - 1);
+        std::size_t const first = std::min(length, ring.capacity - slot);
+        std::memcpy(ring.data.get() + slot, text.data(), first);
+        std::memcpy(ring.data.get(), text.data() + first, length - first);
+        ring.appended.store(position + length, std::memory_order_release);
+        text.remove_prefix(length);
+
+        if (ring.capacity - free + length > ring.capacity / 2) {
+            wake();
+        }
+    }
+}
+
+void Logger::wake() noexcept {
+    if (!wakeup_pending.exchange(true, std::memory_order_acq_rel)) {
+        writer_wakeup.notify_one();
+    }
+}
+
+void Logger::flush() {
+    std::unique_lock lock(mutex);
+    std::uint64_t const ticket = ++flushes_requested;
+    writer_wakeup.notify_one();
+    flushed.wait(lock, [&] { return flushes_done >= ticket; });
+}
+
+void Logger::run_writer() {
+    std::vector<Ring*> snapshot;
+    std::unique_lock lock(mutex);
+    for (;;) {
+        writer_wakeup.wait_for(lock, DRAIN_INTERVAL, [&] {
+            return stopping || flushes_requested != flushes_done || wakeup_pending.load(std::memory_order_relaxed);
+        });
+        bool const stop = stopping;
+        std::uint64_t const requested = flushes_requested;
+        wakeup_pending.store(false, std::memory_order_relaxed);
+        snapshot.clear();
+        for (auto const& ring : rings) {
+            snapshot.push_back(ring.get());
+        }
+        lock.unlock();
+
+        if ((drain(snapshot) || requested != flushes_done) && std::fflush(out) != 0) {
+            write_failed.store(true, std::memory_order_relaxed);
+        }
+
+        lock.lock();
+        flushes_done = requested;
+        flushed.notify_all();
+        if (stop) {
+            return;
+        }
+    }
+}
+
+bool Logger::drain(std::span<Ring* const> snapshot) {
+    for (Ring* ring : snapshot) {
+        std::uint64_t const from = ring->taken.load(std::memory_order_relaxed);
+        std::uint64_t const to = ring->appended.load(std::memory_order_acquire);
+        if (from == to) {
+            continue;
+        }
+        std::size_t const slot = from & (ring->capacity - 1);
+        std::size_t const length = static_cast<std::size_t>(to - from);
+        std::size_t const first = std::min(length, ring->capacity - slot);
+        std::size_t const kept = batch.size();
+        try {
+            batch.append(ring->data.get() + slot, first);
+            batch.append(ring->data.get(), length - first);
+        } catch (std::bad_alloc const&) {
+            // The writer thread must not die on a full heap: drop this ring's text so its producers can go on.
+            batch.resize(kept);
+            write_failed.store(true, std::memory_order_relaxed);
+        }
+        ring->taken.store(to, std::memory_order_release);
+    }
+    if (batch.empty()) {
+        return false;
+    }
+    if (std::fwrite(batch.data(), 1, batch.size(), out) != batch.size()) {
+        write_failed.store(true, std::memory_order_relaxed);
+    }
+    batch.clear();
+    return true;
+}
+
+std::optional<Logger::Level> Logger::level_from_name(std::string_view name) noexcept {
+    if (name == "debug") {
+        return Level::DEBUG;
+    }
+    if (name == "info") {
+        return Level::INFO;
+    }
+    if (name == "warning") {
+        return Level::WARNING;
+    }
+    if (name == "error") {
+        return Level::ERROR;
+    }
+    if (name == "off") {
+        return Level::OFF;
+    }
+    return std::nullopt;
+}
+
+std::unique_ptr<Logger> Logger::from_environment(Level fallback) {
+    Level level = fallback;
+    if (char const* name = std::getenv("GARBAGE_LOG_LEVEL"); name != nullptr && *name != '\0') {
+        std::optional<Level> const parsed = level_from_name(name);
+        if (!parsed) {
+            throw std::invalid_argument(std::string("Unknown log level ") + name);
+        }
+        level = *parsed;
+    }
+    if (char const* path = std::getenv("GARBAGE_LOG_FILE"); path != nullptr && *path != '\0') {
+        return std::make_unique<Logger>(std::string(path), level);
+    }
+    return std::make_unique<Logger>(stdout, level);
+}
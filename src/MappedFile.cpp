@@ -0,0 +1,44 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of MappedFile.
+ */
+
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(std::string const& path, Access access) {
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    if (length == 0) {
+        // mmap rejects empty mappings; an empty file simply has no bytes
+        ::close(fd);
+        return;
+    }
+    address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        address = nullptr;
+        throw std::runtime_error("Cannot map " + path);
+    }
+    ::madvise(address, length, access == Access::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+}
+
+MappedFile::~MappedFile() noexcept {
+    if (address != nullptr) {
+        ::munmap(address, length);
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file Metrics.cpp
+ * @brief Registration, aggregation and export of the runtime metrics.
+ */
+
+#include "Metrics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string_view>
+
+namespace Metrics {
+
+namespace {
+
+/**
+ * @brief Head of the list of registered threads. Threads are only ever added, at the front.
+ */
+std::atomic<ThreadMetrics*> threads { nullptr };
+
+struct CounterInfo {
+    std::string_view name;
+    std::string_view help;
+};
+
+constexpr std::array<CounterInfo, NUM_COUNTERS> COUNTERS = { {
+    { "rounds", "Rounds played" },
+    { "turns", "Turns played" },
+    { "draws", "Cards drawn from the draw pile" },
+    { "discards_taken", "Cards taken from the discard pile" },
+    { "reshuffles", "Times the discard pile became the draw pile" },
+    { "stalemates", "Rounds abandoned as stalemates" },
+    { "deal_nanoseconds", "Wall time spent dealing" },
+    { "turn_nanoseconds", "Wall time spent playing turns" },
+} };
+
+constexpr std::array<CounterInfo, NUM_HISTOGRAMS> HISTOGRAMS = { {
+    { "turns_per_round", "Turns played in each round" },
+    { "chain_length", "Cards placed by each card played" },
+} };
+
+/**
+ * @brief Inclusive upper bound of a bucket; the last bucket has none.
+ */
+constexpr std::uint64_t bucket_bound(std::size_t bucket) noexcept {
+    return (std::uint64_t { 1 } << bucket) - 1;
+}
+
+}
+
+ThreadMetrics& register_thread() {
+    auto* metrics = new ThreadMetrics;
+    ThreadMetrics* head = threads.load(std::memory_order_relaxed);
+    do {
+        metrics->next = head;
+    } while (!threads.compare_exchange_weak(head, metrics, std::memory_order_release, std::memory_order_relaxed));
+    return *metrics;
+}
+
+Snapshot collect() noexcept {
+    Snapshot snapshot;
+    for (ThreadMetrics const* metrics = threads.load(std::memory_order_acquire); metrics != nullptr;
+         metrics = metrics->next) {
+        for (std::size_t c = 0; c < NUM_COUNTERS; ++c) {
+            snapshot.counters[c] += metrics->counters[c].load(std::memory_order_relaxed);
+        }
+        for (std::size_t h = 0; h < NUM_HISTOGRAMS; ++h) {
+            for (std::size_t b = 0; b < NUM_BUCKETS; ++b) {
+                snapshot.buckets[h][b] += metrics->buckets[h][b].load(std::memory_order_relaxed);
+            }
+            snapshot.sums[h] += metrics->sums[h].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+std::string to_json(Snapshot const& snapshot) {
+    std::string json = "{\n  \"counters\": {";
+    for (std::size_t c = 0; c < NUM_COUNTERS; ++c) {
+        json += std::format("{}\n    \"{}\": {}", c > 0 ? "," : "", COUNTERS[c].name, snapshot.counters[c]);
+    }
+    json += "\n  },\n  \"histograms\": {";
+    for (std::size_t h = 0; h < NUM_HISTOGRAMS; ++h) {
+        std::uint64_t count = 0;
+        std::string buckets;
+        for (std::size_t b = 0; b < NUM_BUCKETS; ++b) {
+            count += snapshot.buckets[h][b];
+            buckets += std::format("{}{}", b > 0 ? ", " : "", snapshot.buckets[h][b]);
+        }
+        json += std::format("{}\n    \"{}\": {{\"count\": {}, \"sum\": {}, \"buckets\": [{}]}}", h > 0 ? "," : "",
+                            HISTOGRAMS[h].name, count, snapshot.sums[h], buckets);
+    }
+    json += std::format("\n  }},\n  \"bucket_upper_bounds\": [");
+    for (std::size_t b = 0; b + 1 < NUM_BUCKETS; ++b) {
+        json += std::format("{}{}", b > 0 ? ", " : "", bucket_bound(b));
+    }
+    json += ", null]\n}\n";
+    return json;
+}
+
+std::string to_prometheus(Snapshot const& snapshot) {
+    std::string text;
+    for (std::size_t c = 0; c < NUM_COUNTERS; ++c) {
+        text += std::format("# HELP garbage_{0}_total {1}\n# TYPE garbage_{0}_total counter\ngarbage_{0}_total {2}\n",
+                            COUNTERS[c].name, COUNTERS[c].help, snapshot.counters[c]);
+    }
+    for (std::size_t h = 0; h < NUM_HISTOGRAMS; ++h) {
+        std::string_view const name = HISTOGRAMS[h].name;
+        text += std::format("# HELP garbage_{0} {1}\n# TYPE garbage_{0} histogram\n", name, HISTOGRAMS[h].help);
+        std::uint64_t cumulative = 0;
+        for (std::size_t b = 0; b + 1 < NUM_BUCKETS; ++b) {
+            cumulative += snapshot.buckets[h][b];
+            text += std::format("garbage_{}_bucket{{le=\"{}\"}} {}\n", name, bucket_bound(b), cumulative);
+        }
+        cumulative += snapshot.buckets[h][NUM_BUCKETS - 1];
+        text += std::format("garbage_{0}_bucket{{le=\"+Inf\"}} {1}\ngarbage_{0}_sum {2}\ngarbage_{0}_count {1}\n",
+                            name, cumulative, snapshot.sums[h]);
+    }
+    return text;
+}
+
+void dump_if_requested() {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    char const* const path = std::getenv("GARBAGE_METRICS_OUT");
+    if (path == nullptr || *path == '\0') {
+        return;
+    }
+    std::string_view const name(path);
+    Snapshot const snapshot = collect();
+    std::string const text = name.ends_with(".json") ? to_json(snapshot) : to_prometheus(snapshot);
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path, "w"), &std::fclose);
+    if (!file || std::fwrite(text.data(), 1, text.size(), file.get()) != text.size()) {
+        std::cerr << "Cannot write metrics to " << path << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+/**
+ * @file Oracle.cpp
+ * @brief Implementation of the expected-turns solver and oracle file.
+ */
+
+#include "Oracle.h"
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "Card.h"
+
+std::vector<double> solve_expected_turns(std::size_t max_hand_size) {
+    std::vector<double> table(oracle_entries(max_hand_size));
+    constexpr double RANKS = NUM_RANKS;
+
+    for (std::size_t n = 1; n <= max_hand_size; ++n) {
+        unsigned const full = (1u << n) - 1;
+        // mid_chain[m]: expected turns still needed when a placement has just revealed a card and the mask is m
+        std::vector<double> mid_chain(std::size_t { 1 } << n);
+        double* const expected = table.data() + oracle_index(n, 0);
+        expected[full] = 0.0;
+        mid_chain[full] = 0.0;
+
+        // Placements only add bits, so every successor of m is numerically larger and already solved
+        for (unsigned m = full; m-- > 0;) {
+            unsigned const open = full & ~m;
+            double const k = std::popcount(open);
+            double successors = 0.0;
+            for (unsigned rest = open; rest != 0; rest &= rest - 1) {
+                successors += mid_chain[m | (rest & -rest)];
+            }
+            // E = 1 + (1 - k/13) E + (1/13) sum F  and  F = (1 - k/13) E + (1/13) sum F
+            expected[m] = (RANKS + successors) / k;
+            mid_chain[m] = ((RANKS - k) * expected[m] + successors) / RANKS;
+        }
+    }
+    return table;
+}
+
+void write_oracle(std::string const& path, std::span<double const> table, std::size_t max_hand_size) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (!file) {
+        throw std::runtime_error("Cannot open oracle file " + path);
+    }
+    std::array<std::uint8_t, ORACLE_HEADER_SIZE> header {};
+    std::memcpy(header.data(), ORACLE_MAGIC.data(), ORACLE_MAGIC.size());
+    header[ORACLE_MAGIC.size()] = ORACLE_VERSION;
+    header[ORACLE_MAGIC.size() + 1] = static_cast<std::uint8_t>(max_hand_size);
+    if (std::fwrite(header.data(), 1, header.size(), file.get()) != header.size()
+        || std::fwrite(table.data(), sizeof(double), table.size(), file.get()) != table.size()) {
+        throw std::runtime_error("Cannot write oracle file " + path);
+    }
+}
+
+
+ExpectedTurnsOracle::ExpectedTurnsOracle(std::string const& path)
+    : file(path, MappedFile::Access::RANDOM) {
+    std::span<std::uint8_t const> const bytes = file.bytes();
+    if (bytes.size() < ORACLE_HEADER_SIZE || std::memcmp(bytes.data(), ORACLE_MAGIC.data(), ORACLE_MAGIC.size()) != 0
+        || bytes[ORACLE_MAGIC.size()] != ORACLE_VERSION) {
+        throw std::runtime_error(path + " is not an oracle of version " + std::to_string(ORACLE_VERSION));
+    }
+    max_size = bytes[ORACLE_MAGIC.size() + 1];
+    if (max_size == 0 || max_size > Config::MAX_STARTING_ROUND
+        || bytes.size() != ORACLE_HEADER_SIZE + oracle_entries(max_size) * sizeof(double)) {
+        throw std::runtime_error(path + " has a corrupt oracle table");
+    }
+    // The mapping is page aligned and the header keeps the table 16-byte aligned
+    table = { reinterpret_cast<double const*>(bytes.data() + ORACLE_HEADER_SIZE), oracle_entries(max_size) };
+}
+
+void ExpectedTurnsOracle::reject(std::size_t hand_size, std::uint16_t showing_mask) const {
+    throw std::out_of_range("No oracle entry for a hand of " + std::to_string(hand_size) + " cards with face-up mask "
+                            + std::to_string(showing_mask) + "; the table holds hands of up to "
+                            + std::to_string(max_size) + " cards");
+}
@@ -5,8 +5,8 @@
 
 #include "Player.h"
 
-#include <algorithm>
+#include <utility>
 
-Player* Player_factory(std::string name, short round) {
-    return new ComputerPlayer(std::move(name), std::move(round));
+Player Player_factory(std::string name, short round, Strategy strategy) {
+    return Player(std::move(name), round, strategy);
 }
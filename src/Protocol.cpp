@@ -0,0 +1,151 @@
+/**
+ * @file Protocol.cpp
+ * @brief Encoding and decoding of the game server protocol.
+ */
+
+#include "Protocol.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Protocol {
+
+namespace {
+
+/**
+ * @brief Writes the header in front of a payload of the given size and returns the size of the frame.
+ */
+std::size_t finish(std::span<std::uint8_t> out, Message message, std::size_t payload_size) noexcept {
+    out[0] = static_cast<std::uint8_t>(message);
+    out[1] = static_cast<std::uint8_t>(payload_size);
+    return HEADER_SIZE + payload_size;
+}
+
+void expect_size(Frame const& frame, std::size_t size) {
+    if (frame.payload.size() != size) {
+        throw std::runtime_error("Malformed message of tag " + std::to_string(static_cast<int>(frame.message)));
+    }
+}
+
+Card read_card(std::uint8_t bits) {
+    Card const card = Card::from_bits(bits);
+    if (card.get_rank() < Card::Rank::ACE || card.get_rank() > Card::Rank::KING
+        || card.get_suit() > Card::Suit::DIAMONDS) {
+        throw std::runtime_error("Malformed card " + std::to_string(bits));
+    }
+    return card;
+}
+
+}
+
+std::optional<Frame> parse_frame(std::span<std::uint8_t const> bytes) {
+    if (bytes.size() < HEADER_SIZE) {
+        return std::nullopt;
+    }
+    if (bytes[0] >= static_cast<std::uint8_t>(Message::COUNT)) {
+        throw std::runtime_error("Unknown message tag " + std::to_string(bytes[0]));
+    }
+    std::size_t const payload_size = bytes[1];
+    if (payload_size > MAX_PAYLOAD) {
+        throw std::runtime_error("Message payload of " + std::to_string(payload_size) + " bytes is too long");
+    }
+    if (bytes.size() < HEADER_SIZE + payload_size) {
+        return std::nullopt;
+    }
+    return Frame { static_cast<Message>(bytes[0]), bytes.subspan(HEADER_SIZE, payload_size),
+                   HEADER_SIZE + payload_size };
+}
+
+std::size_t write_hello(std::span<std::uint8_t> out, Hello const& hello) noexcept {
+    out[2] = hello.version;
+    out[3] = hello.num_players;
+    out[4] = hello.starting_round;
+    for (std::size_t i = 0; i < 8; ++i) {
+        out[5 + i] = static_cast<std::uint8_t>(hello.seed >> (8 * i));
+    }
+    return finish(out, Message::HELLO, 11);
+}
+
+std::size_t write_decide(std::span<std::uint8_t> out, bool take_discard) noexcept {
+    out[2] = take_discard ? 1 : 0;
+    return finish(out, Message::DECIDE, 1);
+}
+
+std::size_t write_decision(std::span<std::uint8_t> out, Decision const& decision) noexcept {
+    std::uint16_t const showing = decision.hand.get_showing_mask();
+    out[2] = decision.round;
+    out[3] = decision.top_discard.get_bits();
+    out[4] = static_cast<std::uint8_t>(showing);
+    out[5] = static_cast<std::uint8_t>(showing >> 8);
+    out[6] = static_cast<std::uint8_t>(decision.hand.size());
+    std::ranges::transform(decision.hand.get_cards(), out.begin() + 7, [](Card const& c) { return c.get_bits(); });
+    return finish(out, Message::DECISION, 5 + decision.hand.size());
+}
+
+std::size_t write_game_over(std::span<std::uint8_t> out, GameOver const& game_over) noexcept {
+    out[2] = game_over.num_players;
+    std::copy_n(game_over.rounds.begin(), game_over.num_players, out.begin() + 3);
+    return finish(out, Message::GAME_OVER, 1 + static_cast<std::size_t>(game_over.num_players));
+}
+
+std::size_t write_error(std::span<std::uint8_t> out, Error error) noexcept {
+    out[2] = static_cast<std::uint8_t>(error);
+    return finish(out, Message::ERROR, 1);
+}
+
+Hello read_hello(Frame const& frame) {
+    expect_size(frame, 11);
+    Hello hello;
+    hello.version = frame.payload[0];
+    hello.num_players = frame.payload[1];
+    hello.starting_round = frame.payload[2];
+    hello.seed = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        hello.seed |= static_cast<std::uint64_t>(frame.payload[3 + i]) << (8 * i);
+    }
+    return hello;
+}
+
+bool read_decide(Frame const& frame) {
+    expect_size(frame, 1);
+    return frame.payload[0] != 0;
+}
+
+Decision read_decision(Frame const& frame) {
+    if (frame.payload.size() < 5) {
+        expect_size(frame, 5);
+    }
+    std::size_t const hand_size = frame.payload[4];
+    expect_size(frame, 5 + hand_size);
+    if (hand_size > Config::MAX_STARTING_ROUND) {
+        throw std::runtime_error("A hand holds at most " + std::to_string(Config::MAX_STARTING_ROUND) + " cards");
+    }
+    Decision decision;
+    decision.round = frame.payload[0];
+    decision.top_discard = read_card(frame.payload[1]);
+    auto const showing = static_cast<std::uint16_t>(frame.payload[2] | (frame.payload[3] << 8));
+    for (std::size_t i = 0; i < hand_size; ++i) {
+        decision.hand.add_card(read_card(frame.payload[5 + i]));
+        decision.hand.set_showing(i, (showing >> i) & 1u);
+    }
+    return decision;
+}
+
+GameOver read_game_over(Frame const& frame) {
+    if (frame.payload.empty() || frame.payload[0] > Config::MAX_PLAYER_COUNT) {
+        throw std::runtime_error("Malformed game over message");
+    }
+    GameOver game_over;
+    game_over.num_players = frame.payload[0];
+    expect_size(frame, 1 + static_cast<std::size_t>(game_over.num_players));
+    std::ranges::copy(frame.payload.subspan(1), game_over.rounds.begin());
+    return game_over;
+}
+
+Error read_error(Frame const& frame) {
+    expect_size(frame, 1);
+    return static_cast<Error>(frame.payload[0]);
+}
+
+}
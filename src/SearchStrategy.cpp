@@ -0,0 +1,342 @@
+/**
+ * @file SearchStrategy.cpp
+ * @brief Implementation of the information-set Monte Carlo search strategy.
+ */
+
+#include "SearchStrategy.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Card.h"
+#include "Deck.h"
+#include "EventSink.h"
+#include "Hand.h"
+#include "Player.h"
+#include "Random.h"
+#include "Strategy.h"
+#include "const.h"
+
+namespace {
+
+using Hands = std::array<Hand, Config::MAX_PLAYER_COUNT>;
+
+/**
+ * @brief Everything the player to move knows, and the cards it has not seen.
+ */
+struct InformationSet {
+    /**
+     * @brief The hands at the table. Only their sizes and face-up cards are used.
+     */
+    Hands hands;
+    std::size_t num_players = 0;
+    std::size_t seat = 0;
+    short num_decks = 1;
+    Card top_discard;
+
+    /**
+     * @brief Every card of the shoe that is neither face up in a hand nor in the discard pile.
+     */
+    std::array<Card, Deck::MAX_SHOE_SIZE> unseen;
+    int num_unseen = 0;
+
+    int draw_size = 0;
+
+    /**
+     * @brief The discard pile, top card first. Every player saw each of its cards discarded.
+     */
+    std::array<Card, Deck::MAX_SHOE_SIZE> discard_pile;
+    int discard_size = 0;
+};
+
+/**
+ * @brief Rollouts won by each action.
+ */
+struct Tally {
+    std::uint32_t iterations = 0;
+    std::uint32_t take_wins = 0;
+    std::uint32_t draw_wins = 0;
+};
+
+/**
+ * @brief Helper threads that stay around between decisions, so a decision searched on several threads only wakes
+ * them instead of starting and joining a thread each. Every thread that searches owns one (see take_discard), so
+ * games on different threads never wait for each other's helpers.
+ */
+class SearchPool {
+public:
+    SearchPool() = default;
+    SearchPool(SearchPool const&) = delete;
+    SearchPool& operator=(SearchPool const&) = delete;
+
+    /**
+     * @brief Stops the helpers; they are joined as the pool goes away.
+     */
+    ~SearchPool() {
+        {
+            std::lock_guard const lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+    }
+
+    /**
+     * @brief Runs job(t) for every t below num_jobs and returns once all are done: job 0 on the calling thread, the
+     * others on helpers, which are started the first time that many are needed. The job must not throw.
+     */
+    template <typename Job>
+    void run(unsigned num_jobs, Job const& job) {
+        while (helpers.size() + 1 < num_jobs) {
+            // Only the calling thread changes generation, so the new helper starts from the current one
+            helpers.emplace_back([this, t = static_cast<unsigned>(helpers.size() + 1), seen = generation] {
+                work(t, seen);
+            });
+        }
+        {
+            std::lock_guard const lock(mutex);
+            context = &job;
+            call = [](void const* c, unsigned t) { (*static_cast<Job const*>(c))(t); };
+            jobs = num_jobs;
+            pending = num_jobs - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        job(0);
+        std::unique_lock lock(mutex);
+        done.wait(lock, [&] { return pending == 0; });
+    }
+
+private:
+    void work(unsigned t, std::uint64_t seen) {
+        std::unique_lock lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            if (t >= jobs) {
+                continue;
+            }
+            void (*const job)(void const*, unsigned) = call;
+            void const* const job_context = context;
+            lock.unlock();
+            job(job_context, t);
+            lock.lock();
+            if (--pending == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    void (*call)(void const*, unsigned) = nullptr;
+    void const* context = nullptr;
+    unsigned jobs = 0;
+    unsigned pending = 0;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+
+    /**
+     * @brief Declared last, so the helpers are joined before the state they wait on is destroyed.
+     */
+    std::vector<std::jthread> helpers;
+};
+
+InformationSet observe(TurnView const& view) noexcept {
+    InformationSet info;
+    info.num_players = std::min(view.players.size(), info.hands.size());
+    info.seat = view.seat;
+    info.num_decks = view.deck.get_num_decks();
+    info.top_discard = view.top_discard;
+    info.draw_size = view.deck.size();
+
+    // Copies of each card in sight, indexed by suit and rank
+    auto const index = [](Card const& card) {
+        return static_cast<std::size_t>(card.get_suit()) * NUM_RANKS + static_cast<std::size_t>(card.get_rank()) - 1;
+    };
+    std::array<std::uint8_t, Deck::CARDS_PER_DECK> seen {};
+    std::span<Card const> const pile = view.tracker.get_discard_pile();
+    if (pile.empty()) {
+        info.discard_pile[info.discard_size++] = view.top_discard;
+    }
+    for (auto card = pile.rbegin(); card != pile.rend(); ++card) {
+        info.discard_pile[info.discard_size++] = *card;
+    }
+    for (int i = 0; i < info.discard_size; ++i) {
+        ++seen[index(info.discard_pile[i])];
+    }
+    for (std::size_t p = 0; p < info.num_players; ++p) {
+        Hand const& hand = view.players[p].get_hand();
+        info.hands[p] = hand;
+        for (std::size_t i = 0; i < hand.size(); ++i) {
+            if (hand.is_showing(i)) {
+                ++seen[index(hand.get_card(i))];
+            }
+        }
+    }
+    for (int suit = 0; suit < NUM_SUITS; ++suit) {
+        for (int rank = 1; rank <= NUM_RANKS; ++rank) {
+            Card const card(static_cast<Card::Rank>(rank), static_cast<Card::Suit>(suit));
+            for (int copy = seen[index(card)]; copy < info.num_decks; ++copy) {
+                info.unseen[info.num_unseen++] = card;
+            }
+        }
+    }
+    return info;
+}
+
+/**
+ * @brief Copies the face-up cards of a hand and fills its face-down positions with sampled cards.
+ */
+Hand sample_hand(Hand const& known, std::span<Card const> sample, int& next) noexcept {
+    Hand hand;
+    for (std::size_t i = 0; i < known.size(); ++i) {
+        hand.add_card(known.is_showing(i) ? known.get_card(i) : sample[next++]);
+    }
+    for (std::size_t i = 0; i < known.size(); ++i) {
+        hand.set_showing(i, known.is_showing(i));
+    }
+    return hand;
+}
+
+std::size_t count_face_up(Hands const& hands, std::size_t num_players) noexcept {
+    std::size_t face_up = 0;
+    for (std::size_t p = 0; p < num_players; ++p) {
+        face_up += hands[p].count_showing();
+    }
+    return face_up;
+}
+
+/**
+ * @brief Plays the rest of the round from a determinization with the rules of Game::take_turns. The player to move
+ * starts with the given action; after that everybody plays greedily.
+ * @return True if the player to move completes their hand this round.
+ */
+bool rollout(Hands hands, Deck deck, std::size_t num_players, std::size_t seat, bool take_discard) noexcept {
+    NullSink sink;
+    std::size_t face_up = count_face_up(hands, num_players);
+    short idle_reshuffles = 0;
+    bool any_won = false;
+    bool first_turn = true;
+    for (std::size_t i = seat; !any_won; i = 0) {
+        for (; i < num_players; ++i) {
+            Hand& hand = hands[i];
+            if (deck.empty()) {
+                std::size_t const now_face_up = count_face_up(hands, num_players);
+                if (now_face_up != face_up) {
+                    face_up = now_face_up;
+                    idle_reshuffles = 0;
+                } else if (++idle_reshuffles > Config::MAX_IDLE_RESHUFFLES) {
+                    return false;
+                }
+                deck.reset();
+                deck.shuffle();
+            }
+            // One dispatch on the hand size serves both hand operations of the turn
+            with_hand_size(hand.size(), [&](auto n) {
+                constexpr std::size_t N = decltype(n)::value;
+                bool const take = first_turn ? take_discard : hand.card_is_playable<N>(deck.peek_discard());
+                Card const card = take ? deck.take_discard() : deck.deal_one();
+                deck.discard(hand.play_card<N>(card, sink));
+            });
+            first_turn = false;
+            any_won |= hand.is_completed();
+        }
+    }
+    return hands[seat].is_completed();
+}
+
+/**
+ * @brief Samples determinizations and plays both actions out from each one until either budget runs out.
+ */
+Tally search(InformationSet const& info, std::uint64_t stream, std::uint32_t max_iterations,
+             std::chrono::steady_clock::time_point deadline) noexcept {
+    Rng rng(stream);
+    std::array<Card, Deck::MAX_SHOE_SIZE> sample = info.unseen;
+
+    // Sized once; every determinization starts from a copy of it
+    Deck shoe(stream);
+    shoe.set_num_decks(info.num_decks);
+    shoe.set_shuffle_mode(Deck::ShuffleMode::LAZY);
+
+    Tally tally;
+    while (tally.iterations < max_iterations && std::chrono::steady_clock::now() < deadline) {
+        for (int i = info.num_unseen - 1; i > 0; --i) {
+            std::swap(sample[i], sample[random_below(rng, static_cast<std::uint32_t>(i + 1))]);
+        }
+        Hands hands;
+        int next = 0;
+        for (std::size_t p = 0; p < info.num_players; ++p) {
+            hands[p] = sample_hand(info.hands[p], sample, next);
+        }
+        std::span<Card const> const draw_pile(sample.data() + next, info.draw_size);
+
+        Deck deck = shoe;
+        deck.seed(rng());
+        deck.set_piles(draw_pile, std::span<Card const>(info.discard_pile.data(), info.discard_size));
+
+        // Both actions see the same hidden cards and the same reshuffles
+        tally.take_wins += rollout(hands, deck, info.num_players, info.seat, true);
+        tally.draw_wins += rollout(hands, deck, info.num_players, info.seat, false);
+        ++tally.iterations;
+    }
+    return tally;
+}
+
+}
+
+bool SearchStrategy::take_discard(TurnView const& view) const {
+    // Taking a discard that cannot be placed only passes the turn, so search only weighs placing the discard
+    // against drawing.
+    if (!view.hand.card_is_playable(view.top_discard)) {
+        return false;
+    }
+    if (rollouts == 0 && time_budget.count() == 0) {
+        return true;
+    }
+
+    InformationSet const info = observe(view);
+    auto const deadline = time_budget.count() > 0 ? std::chrono::steady_clock::now() + time_budget
+                                                  : std::chrono::steady_clock::time_point::max();
+    unsigned const num_threads = std::max(1u, threads);
+    std::uint64_t const first_stream = decisions++ * num_threads;
+
+    auto const iterations_for = [&](unsigned t) {
+        if (rollouts == 0) {
+            return std::numeric_limits<std::uint32_t>::max();
+        }
+        return rollouts / num_threads + (t < rollouts % num_threads ? 1 : 0);
+    };
+
+    Tally total;
+    if (num_threads == 1) {
+        total = search(info, stream_seed(seed, first_stream), iterations_for(0), deadline);
+    } else {
+        // Both are kept per thread and only ever grow, so after the first decision searching allocates nothing
+        thread_local SearchPool pool;
+        thread_local std::vector<Tally> tallies;
+        tallies.resize(num_threads);
+        // Named through a pointer: on a helper, tallies would be the helper's own thread_local
+        Tally* const results = tallies.data();
+        pool.run(num_threads, [&, results](unsigned t) {
+            results[t] = search(info, stream_seed(seed, first_stream + t), iterations_for(t), deadline);
+        });
+        for (auto const& tally : std::span(tallies.data(), num_threads)) {
+            total.iterations += tally.iterations;
+            total.take_wins += tally.take_wins;
+            total.draw_wins += tally.draw_wins;
+        }
+    }
+
+    return total.take_wins >= total.draw_wins;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file Stats.cpp
+ * @brief Implementation of the streaming statistics.
+ */
+
+#include "Stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr double GAMMA = (1.0 + QuantileSketch::RELATIVE_ACCURACY) / (1.0 - QuantileSketch::RELATIVE_ACCURACY);
+
+/**
+ * @brief Upper bound of bucket 0. Positive values below it share that bucket, so they lose the accuracy guarantee.
+ */
+constexpr double SMALLEST = 1.0;
+
+double const LOG_GAMMA = std::log(GAMMA);
+
+}
+
+void RunningStats::add(double value) noexcept {
+    ++n;
+    double const delta = value - running_mean;
+    running_mean += delta / static_cast<double>(n);
+    m2 += delta * (value - running_mean);
+    lowest = std::min(lowest, value);
+    highest = std::max(highest, value);
+}
+
+void RunningStats::merge(RunningStats const& other) noexcept {
+    if (other.n == 0) {
+        return;
+    }
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    double const na = static_cast<double>(n);
+    double const nb = static_cast<double>(other.n);
+    double const total = na + nb;
+    double const delta = other.running_mean - running_mean;
+    running_mean += delta * nb / total;
+    m2 += other.m2 + delta * delta * na * nb / total;
+    n += other.n;
+    lowest = std::min(lowest, other.lowest);
+    highest = std::max(highest, other.highest);
+}
+
+double RunningStats::variance() const noexcept {
+    return n > 1 ? m2 / static_cast<double>(n - 1) : 0.0;
+}
+
+double RunningStats::stddev() const noexcept {
+    return std::sqrt(variance());
+}
+
+Interval RunningStats::mean_interval(double z) const noexcept {
+    double const half_width = n > 0 ? z * stddev() / std::sqrt(static_cast<double>(n)) : 0.0;
+    return { mean() - half_width, mean() + half_width };
+}
+
+void QuantileSketch::add(double value) noexcept {
+    ++total;
+    if (!(value > 0.0)) {
+        ++zeros;
+        return;
+    }
+    // Bucket i > 0 holds (SMALLEST * GAMMA^(i-1), SMALLEST * GAMMA^i]
+    double const index = std::ceil(std::log(value / SMALLEST) / LOG_GAMMA);
+    ++buckets[static_cast<std::size_t>(std::clamp(index, 0.0, static_cast<double>(NUM_BUCKETS - 1)))];
+}
+
+void QuantileSketch::merge(QuantileSketch const& other) noexcept {
+    total += other.total;
+    zeros += other.zeros;
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+double QuantileSketch::quantile(double q) const noexcept {
+    if (total == 0) {
+        return 0.0;
+    }
+    auto const rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(total - 1));
+    std::uint64_t seen = zeros;
+    if (rank < seen) {
+        return 0.0;
+    }
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (rank < seen) {
+            return SMALLEST * 2.0 * std::pow(GAMMA, static_cast<double>(i)) / (GAMMA + 1.0);
+        }
+    }
+    return SMALLEST * std::pow(GAMMA, static_cast<double>(NUM_BUCKETS - 1));
+}
+
+Interval wilson_interval(std::uint64_t successes, std::uint64_t trials, double z) noexcept {
+    if (trials == 0) {
+        return { 0.0, 1.0 };
+    }
+    double const n = static_cast<double>(trials);
+    double const p = static_cast<double>(successes) / n;
+    double const z2 = z * z;
+    double const centre = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+    double const half_width = z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / (1.0 + z2 / n);
+    return { std::max(0.0, centre - half_width), std::min(1.0, centre + half_width) };
+}
+
+Sprt::Sprt(double mu0_in, double mu1_in, double alpha, double beta)
+    : mu0(mu0_in)
+    , mu1(mu1_in) {
+    if (mu0 == mu1) {
+        throw std::invalid_argument("The hypotheses of a test must have different means");
+    }
+    if (!(alpha > 0.0 && alpha < 1.0) || !(beta > 0.0 && beta < 1.0)) {
+        throw std::invalid_argument("The error rates of a test must be between 0 and 1");
+    }
+    lower = std::log(beta / (1.0 - alpha));
+    upper = std::log((1.0 - beta) / alpha);
+}
+
+double Sprt::llr(RunningStats const& stats) const noexcept {
+    if (stats.count() < 2) {
+        return 0.0;
+    }
+    // Observations that never vary would make the ratio infinite; a tiny floor keeps its sign
+    double const variance = std::max(stats.variance(), 1e-12);
+    double const n = static_cast<double>(stats.count());
+    return (mu1 - mu0) * n * (stats.mean() - (mu0 + mu1) / 2.0) / variance;
+}
+
+Sprt::Decision Sprt::decide(RunningStats const& stats) const noexcept {
+    double const ratio = llr(stats);
+    if (stats.count() < 2 || (ratio > lower && ratio < upper)) {
+        return Decision::CONTINUE;
+    }
+    return ratio >= upper ? Decision::ACCEPT_H1 : Decision::ACCEPT_H0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file Strategy.cpp
+ * @brief Implementation of strategy parsing.
+ */
+
+#include "Strategy.h"
+
+#include <charconv>
+
+namespace {
+
+/**
+ * @brief Parses a whole string as an unsigned number.
+ */
+template <typename T>
+bool parse_number(std::string_view text, T& value) noexcept {
+    auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc {} && end == text.data() + text.size();
+}
+
+/**
+ * @brief Splits off the text before the next ':'.
+ */
+std::string_view next_field(std::string_view& text) noexcept {
+    std::size_t const colon = text.find(':');
+    std::string_view const field = text.substr(0, colon);
+    text = colon == std::string_view::npos ? std::string_view {} : text.substr(colon + 1);
+    return field;
+}
+
+}
+
+std::optional<Strategy> strategy_from_name(std::string_view name) {
+    std::string_view const kind = next_field(name);
+    if (kind == "greedy" && name.empty()) {
+        return GreedyStrategy {};
+    }
+    if (kind == "draw" && name.empty()) {
+        return DrawOnlyStrategy {};
+    }
+    if (kind != "search") {
+        return std::nullopt;
+    }
+
+    SearchStrategy search;
+    std::string_view const budget = next_field(name);
+    if (budget.ends_with("us") || budget.ends_with("ms")) {
+        std::uint32_t amount = 0;
+        if (!parse_number(budget.substr(0, budget.size() - 2), amount) || amount == 0) {
+            return std::nullopt;
+        }
+        search.rollouts = 0;
+        search.time_budget = budget.ends_with("ms") ? std::chrono::microseconds(amount * 1000ull)
+                                                    : std::chrono::microseconds(amount);
+    } else if (!budget.empty() && (!parse_number(budget, search.rollouts) || search.rollouts == 0)) {
+        return std::nullopt;
+    }
+    std::string_view const threads = next_field(name);
+    if (!threads.empty() && (!parse_number(threads, search.threads) || search.threads == 0)) {
+        return std::nullopt;
+    }
+    if (!name.empty()) {
+        return std::nullopt;
+    }
+    return search;
+}
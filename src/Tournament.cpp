@@ -0,0 +1,249 @@
+/**
+ * @file Tournament.cpp
+ * @brief Implementation of tournaments and Elo ratings.
+ */
+
+#include "Tournament.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include "EventSink.h"
+#include "Game.h"
+#include "Player.h"
+#include "Random.h"
+#include "WorkStealing.h"
+
+namespace {
+
+/**
+ * @brief The matches of a tournament, stored flat: seats_per_match entrant indices per match.
+ */
+struct Schedule {
+    short seats_per_match = 2;
+    std::vector<std::uint16_t> seats;
+    std::vector<short> starting_rounds;
+
+    std::size_t size() const noexcept { return starting_rounds.size(); }
+
+    std::span<std::uint16_t const> seats_of(std::size_t match) const noexcept {
+        return std::span(seats).subspan(match * static_cast<std::size_t>(seats_per_match),
+                                        static_cast<std::size_t>(seats_per_match));
+    }
+};
+
+void validate(TournamentConfig const& config) {
+    if (config.entrants.size() < 2) {
+        throw std::invalid_argument("A tournament needs at least 2 entrants");
+    }
+    if (config.entrants.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::invalid_argument("A tournament holds at most "
+                                    + std::to_string(std::numeric_limits<std::uint16_t>::max()) + " entrants");
+    }
+    if (config.starting_rounds.empty()) {
+        throw std::invalid_argument("A tournament needs at least one starting round");
+    }
+    for (short round : config.starting_rounds) {
+        if (round < 1 || round > Config::MAX_STARTING_ROUND) {
+            throw std::invalid_argument("starting rounds must be between 1 and "
+                                        + std::to_string(Config::MAX_STARTING_ROUND));
+        }
+    }
+    if (config.format == TournamentConfig::Format::RANDOM_PAIRING) {
+        auto const most_seats = std::min<std::size_t>(config.entrants.size(), Config::MAX_PLAYER_COUNT);
+        if (config.players_per_match < 2 || static_cast<std::size_t>(config.players_per_match) > most_seats) {
+            throw std::invalid_argument("players_per_match must be between 2 and " + std::to_string(most_seats));
+        }
+        short const highest_round = *std::ranges::max_element(config.starting_rounds);
+        if (Game::min_decks(static_cast<std::size_t>(config.players_per_match), highest_round) > Config::MAX_DECKS) {
+            throw std::invalid_argument("The tables are too large to deal from the largest shoe");
+        }
+    }
+}
+
+Schedule make_schedule(TournamentConfig const& config) {
+    Schedule schedule;
+    std::size_t const num_entrants = config.entrants.size();
+    if (config.format == TournamentConfig::Format::ROUND_ROBIN) {
+        schedule.seats_per_match = 2;
+        for (short round : config.starting_rounds) {
+            for (std::size_t i = 0; i < num_entrants; ++i) {
+                for (std::size_t j = i + 1; j < num_entrants; ++j) {
+                    for (std::uint64_t g = 0; g < config.games_per_pairing; ++g) {
+                        // Alternate who sits first, since the first seat moves first
+                        bool const swap = g % 2 == 1;
+                        schedule.seats.push_back(static_cast<std::uint16_t>(swap ? j : i));
+                        schedule.seats.push_back(static_cast<std::uint16_t>(swap ? i : j));
+                        schedule.starting_rounds.push_back(round);
+                    }
+                }
+            }
+        }
+        return schedule;
+    }
+
+    // Drawn from a stream of its own, apart from the streams the matches deal from
+    schedule.seats_per_match = config.players_per_match;
+    Rng rng(SplitMix64::mix(config.seed ^ 0x70A7E1E5ull));
+    std::vector<std::uint16_t> pool(num_entrants);
+    std::iota(pool.begin(), pool.end(), std::uint16_t { 0 });
+    for (std::uint64_t m = 0; m < config.num_matches; ++m) {
+        for (short s = 0; s < config.players_per_match; ++s) {
+            auto const pick = s + random_below(rng, static_cast<std::uint32_t>(num_entrants - s));
+            std::swap(pool[static_cast<std::size_t>(s)], pool[pick]);
+            schedule.seats.push_back(pool[static_cast<std::size_t>(s)]);
+        }
+        schedule.starting_rounds.push_back(
+            config.starting_rounds[random_below(rng, static_cast<std::uint32_t>(config.starting_rounds.size()))]);
+    }
+    return schedule;
+}
+
+/**
+ * @brief Rough relative cost of a match: turns grow with the table and more than linearly with the starting round.
+ */
+std::uint64_t estimated_cost(Schedule const& schedule, std::size_t match) noexcept {
+    auto const round = static_cast<std::uint64_t>(schedule.starting_rounds[match]);
+    return static_cast<std::uint64_t>(schedule.seats_per_match) * round * round;
+}
+
+}
+
+EloRatings::EloRatings(std::size_t num_entrants, double k_in)
+    : k(k_in)
+    , ratings(num_entrants, INITIAL_RATING)
+    , games_played(num_entrants, 0)
+    , games_won(num_entrants, 0) {}
+
+double EloRatings::expected_score(double a, double b) noexcept {
+    return 1.0 / (1.0 + std::pow(10.0, (b - a) / 400.0));
+}
+
+void EloRatings::record(std::span<std::uint16_t const> seats, std::span<short const> final_rounds) noexcept {
+    std::size_t const n = std::min({ seats.size(), final_rounds.size(), std::size_t { Config::MAX_PLAYER_COUNT } });
+    if (n < 2) {
+        return;
+    }
+    // Every pair is scored against the ratings from before the game
+    std::array<double, Config::MAX_PLAYER_COUNT> delta {};
+    double const pair_k = k / static_cast<double>(n - 1);
+    for (std::size_t a = 0; a < n; ++a) {
+        for (std::size_t b = a + 1; b < n; ++b) {
+            double const score = final_rounds[a] < final_rounds[b]    ? 1.0
+                                 : final_rounds[a] == final_rounds[b] ? 0.5
+                                                                      : 0.0;
+            double const change = pair_k * (score - expected_score(ratings[seats[a]], ratings[seats[b]]));
+            delta[a] += change;
+            delta[b] -= change;
+        }
+    }
+    for (std::size_t s = 0; s < n; ++s) {
+        ratings[seats[s]] += delta[s];
+        ++games_played[seats[s]];
+        games_won[seats[s]] += final_rounds[s] == 0 ? 1 : 0;
+    }
+}
+
+TournamentResult run_tournament(TournamentConfig const& config) {
+    validate(config);
+    Schedule const schedule = make_schedule(config);
+    if (schedule.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("A tournament holds at most 2^32 - 1 matches");
+    }
+    auto const seats_per_match = static_cast<std::size_t>(schedule.seats_per_match);
+
+    std::vector<std::uint32_t> order(schedule.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::ranges::stable_sort(order, std::greater {}, [&](std::uint32_t m) { return estimated_cost(schedule, m); });
+
+    std::vector<short> final_rounds(schedule.size() * seats_per_match);
+    std::vector<std::atomic<bool>> finished(schedule.size());
+
+    // The first exception thrown by a match, rethrown once the workers are done. Later matches are skipped, but
+    // still marked finished so the rating loop never waits on them.
+    std::atomic<bool> failed { false };
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto const fail = [&] {
+        std::scoped_lock const lock(error_mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+        failed.store(true, std::memory_order_release);
+    };
+    auto const finish = [&](std::uint32_t match) {
+        finished[match].store(true, std::memory_order_release);
+        finished[match].notify_one();
+    };
+
+    auto const play_match_or_throw = [&](std::uint32_t match) {
+        std::uint64_t const game_seed = stream_seed(config.seed, match);
+        short const starting_round = schedule.starting_rounds[match];
+        std::span<std::uint16_t const> const seats = schedule.seats_of(match);
+        std::vector<Player> players;
+        players.reserve(seats.size());
+        for (std::size_t s = 0; s < seats.size(); ++s) {
+            Entrant const& entrant = config.entrants[seats[s]];
+            Strategy strategy = entrant.strategy;
+            if (auto* search = std::get_if<SearchStrategy>(&strategy)) {
+                search->seed = stream_seed(game_seed, s);
+            }
+            players.push_back(Player_factory(entrant.name, starting_round, strategy));
+        }
+        NullSink sink;
+        Game game(std::move(players), starting_round, true, sink, game_seed);
+        game.play();
+        for (std::size_t s = 0; s < seats.size(); ++s) {
+            final_rounds[match * seats_per_match + s] = game.get_players()[s].get_round();
+        }
+    };
+    auto const play_match = [&](std::uint32_t match) {
+        if (!failed.load(std::memory_order_acquire)) {
+            try {
+                play_match_or_throw(match);
+            } catch (...) {
+                fail();
+            }
+        }
+        finish(match);
+    };
+
+    TournamentResult result { EloRatings(config.entrants.size()), schedule.size(), 0 };
+    {
+        std::jthread workers([&] {
+            try {
+                result.steals = run_work_stealing(order, config.num_threads, play_match).steals;
+            } catch (...) {
+                // The pool could not start; release the rating loop from matches that will never be played
+                fail();
+                for (std::uint32_t match : order) {
+                    finish(match);
+                }
+            }
+        });
+        for (std::size_t rated = 0; rated < order.size(); ++rated) {
+            std::uint32_t const match = order[rated];
+            finished[match].wait(false, std::memory_order_acquire);
+            if (failed.load(std::memory_order_acquire)) {
+                break;
+            }
+            result.ratings.record(schedule.seats_of(match),
+                                  std::span(final_rounds).subspan(match * seats_per_match, seats_per_match));
+            if (config.on_progress && config.progress_interval > 0 && (rated + 1) % config.progress_interval == 0) {
+                config.on_progress(rated + 1, result.ratings);
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
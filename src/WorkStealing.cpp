@@ -0,0 +1,127 @@
+/**
+ * @file WorkStealing.cpp
+ * @brief Implementation of the work-stealing deque and pool.
+ */
+
+#include "WorkStealing.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include <vector>
+
+#include "Random.h"
+
+TaskDeque::TaskDeque(std::size_t capacity)
+    : mask(std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1)
+    , tasks(new std::atomic<std::uint32_t>[mask + 1]) {}
+
+void TaskDeque::push(std::uint32_t task) noexcept {
+    std::int64_t const b = bottom.load(std::memory_order_relaxed);
+    tasks[static_cast<std::size_t>(b) & mask].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+std::optional<std::uint32_t> TaskDeque::take() noexcept {
+    std::int64_t const b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    std::optional<std::uint32_t> task = tasks[static_cast<std::size_t>(b) & mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        // The last task: race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task.reset();
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+std::optional<std::uint32_t> TaskDeque::steal(bool& contended) noexcept {
+    contended = false;
+    std::int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t const b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return std::nullopt;
+    }
+    std::uint32_t const task = tasks[static_cast<std::size_t>(t) & mask].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        contended = true;
+        return std::nullopt;
+    }
+    return task;
+}
+
+
+WorkStealingStats run_work_stealing(std::span<std::uint32_t const> tasks, unsigned num_threads,
+                                    std::function<void(std::uint32_t task)> const& body) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = static_cast<unsigned>(std::clamp<std::size_t>(tasks.size(), 1, num_threads));
+
+    // Worker w is dealt tasks w, w + n, ... and pushes them cheapest first, so it takes its most expensive one first
+    // and thieves take its cheapest
+    std::vector<std::unique_ptr<TaskDeque>> deques;
+    for (unsigned w = 0; w < num_threads; ++w) {
+        std::size_t const count = (tasks.size() + num_threads - 1 - w) / num_threads;
+        deques.push_back(std::make_unique<TaskDeque>(count));
+        for (std::size_t i = count; i-- > 0;) {
+            deques[w]->push(tasks[w + i * num_threads]);
+        }
+    }
+
+    std::vector<WorkStealingStats> stats(num_threads);
+    auto const work = [&](unsigned w) {
+        Rng rng(w);
+        for (;;) {
+            if (std::optional<std::uint32_t> const task = deques[w]->take()) {
+                body(*task);
+                ++stats[w].tasks_run;
+                continue;
+            }
+
+            // Nothing is ever pushed once the run starts, so when every deque is empty the run is over
+            bool any_contended = false;
+            std::optional<std::uint32_t> stolen;
+            unsigned const first = static_cast<unsigned>(random_below(rng, num_threads));
+            for (unsigned i = 0; i < num_threads && !stolen; ++i) {
+                unsigned const victim = (first + i) % num_threads;
+                bool contended = false;
+                if (victim != w) {
+                    stolen = deques[victim]->steal(contended);
+                    any_contended |= contended;
+                }
+            }
+            if (stolen) {
+                body(*stolen);
+                ++stats[w].tasks_run;
+                ++stats[w].steals;
+            } else if (!any_contended) {
+                return;
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(num_threads);
+        for (unsigned w = 0; w < num_threads; ++w) {
+            workers.emplace_back(work, w);
+        }
+    }
+
+    WorkStealingStats total;
+    for (WorkStealingStats const& worker : stats) {
+        total.tasks_run += worker.tasks_run;
+        total.steals += worker.steals;
+    }
+    return total;
+}
@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <generator>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Card.h"
+#include "Deck.h"
+#include "EventSink.h"
+#include "Game.h"
+#include "GameSnapshot.h"
+#include "Hand.h"
+#include "Player.h"
+#include "Random.h"
+#include "const.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Repetitions run and thrown away before measuring, to warm up caches and branch predictors.
+ */
+constexpr std::size_t WARMUP_REPETITIONS = 3;
+
+/**
+ * @brief Shortest duration of one repetition; the number of calls per repetition is doubled until it is reached.
+ */
+constexpr std::chrono::microseconds MIN_REPETITION_TIME { 2000 };
+
+/**
+ * @brief Keeps a value alive so the compiler cannot drop the work that produced it.
+ */
+template <typename T>
+void keep(T const& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Timing of one benchmark, per operation.
+ */
+struct Measurement {
+    std::string name;
+    std::uint64_t ops_per_repetition = 0;
+    std::size_t repetitions = 0;
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+
+    /**
+     * @brief The slowest repetition. A tail percentile would need far more repetitions than a benchmark run makes.
+     */
+    double max_ns = 0.0;
+};
+
+/**
+ * @brief Runs benchmarks and collects their measurements.
+ */
+class Bench {
+public:
+    Bench(std::size_t repetitions_in, std::string_view filter_in)
+        : repetitions(repetitions_in)
+        , filter(filter_in) {}
+
+    /**
+     * @brief Measures a benchmark body.
+     * @param name Name of the benchmark; skipped unless it contains the filter.
+     * @param ops_per_call Number of operations one call of body performs.
+     * @param body The code to time.
+     */
+    template <typename Body>
+    void run(std::string name, std::uint64_t ops_per_call, Body&& body) {
+        measure(std::move(name), ops_per_call, [&](std::uint64_t calls) { return time_calls(body, calls); });
+    }
+
+    /**
+     * @brief Measures a benchmark body that needs fresh state for every call.
+     * @param setup Prepares the state for one call of body. It runs before every call and is not timed.
+     */
+    template <typename Setup, typename Body>
+    void run(std::string name, std::uint64_t ops_per_call, Setup&& setup, Body&& body) {
+        measure(std::move(name), ops_per_call, [&](std::uint64_t calls) { return time_calls(setup, body, calls); });
+    }
+
+    std::vector<Measurement> const& get_results() const noexcept { return results; }
+
+private:
+    /**
+     * @brief Finds a number of calls that takes long enough to time, then records the timing of repetitions of them.
+     * @param time Times the given number of calls.
+     */
+    template <typename Time>
+    void measure(std::string name, std::uint64_t ops_per_call, Time&& time) {
+        if (name.find(filter) == std::string::npos) {
+            return;
+        }
+
+        std::uint64_t calls = 1;
+        while (time(calls) < MIN_REPETITION_TIME && calls < (std::uint64_t { 1 } << 40)) {
+            calls *= 2;
+        }
+        for (std::size_t i = 0; i < WARMUP_REPETITIONS; ++i) {
+            time(calls);
+        }
+
+        std::vector<double> samples(repetitions);
+        double const ops = static_cast<double>(calls * ops_per_call);
+        for (auto& sample : samples) {
+            sample = std::chrono::duration<double, std::nano>(time(calls)).count() / ops;
+        }
+        std::ranges::sort(samples);
+
+        Measurement measurement { std::move(name), calls * ops_per_call, repetitions, percentile(samples, 0.5),
+                                  samples.front(), samples.back() };
+        std::println("{:<44} {:>12.2f} {:>12.2f} {:>14.0f}", measurement.name, measurement.median_ns,
+                     measurement.max_ns, 1e9 / measurement.median_ns);
+        results.push_back(std::move(measurement));
+    }
+
+    template <typename Body>
+    static Clock::duration time_calls(Body& body, std::uint64_t calls) {
+        auto const start = Clock::now();
+        for (std::uint64_t i = 0; i < calls; ++i) {
+            body();
+        }
+        return Clock::now() - start;
+    }
+
+    template <typename Setup, typename Body>
+    static Clock::duration time_calls(Setup& setup, Body& body, std::uint64_t calls) {
+        Clock::duration total {};
+        for (std::uint64_t i = 0; i < calls; ++i) {
+            setup();
+            auto const start = Clock::now();
+            body();
+            total += Clock::now() - start;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Nearest-rank percentile of sorted samples.
+     */
+    static double percentile(std::vector<double> const& sorted, double p) noexcept {
+        auto const rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    std::size_t repetitions;
+    std::string filter;
+    std::vector<Measurement> results;
+};
+
+std::vector<Player> make_players(short num_players, short starting_round) {
+    std::vector<Player> players;
+    for (short i = 0; i < num_players; ++i) {
+        players.push_back(Player_factory("Player " + std::to_string(i + 1), starting_round));
+    }
+    return players;
+}
+
+/**
+ * @brief Shuffled deck orders, so rounds can be dealt from a fixed but random-looking script.
+ */
+std::vector<std::vector<Card>> make_deck_orders(std::size_t count) {
+    std::vector<std::vector<Card>> orders(count);
+    Deck deck(1);
+    for (auto& order : orders) {
+        deck.redeal();
+        deck.shuffle();
+        while (!deck.empty()) {
+            order.push_back(deck.deal_one());
+        }
+    }
+    return orders;
+}
+
+void bench_deck(Bench& bench) {
+    Deck deck(1);
+    bench.run("Deck::shuffle (eager, 52 cards)", 1, [&] {
+        deck.redeal();
+        deck.shuffle();
+        keep(deck);
+    });
+
+    deck.set_shuffle_mode(Deck::ShuffleMode::LAZY);
+    bench.run("Deck::deal_one (lazy shuffle)", 52, [&] {
+        deck.redeal();
+        deck.shuffle();
+        unsigned bits = 0;
+        for (int i = 0; i < 52; ++i) {
+            bits += deck.deal_one().get_bits();
+        }
+        keep(bits);
+    });
+
+    bench.run("Deck::deal_one (unshuffled)", 52, [&] {
+        deck.redeal();
+        unsigned bits = 0;
+        for (int i = 0; i < 52; ++i) {
+            bits += deck.deal_one().get_bits();
+        }
+        keep(bits);
+    });
+}
+
+void bench_hand(Bench& bench) {
+    constexpr std::size_t NUM_CARDS = 1 << 16;
+    constexpr int PLAYS = 32;
+    std::vector<Card> cards(NUM_CARDS);
+    Rng rng(2);
+    for (auto& card : cards) {
+        card = Card(static_cast<Card::Rank>(1 + random_below(rng, NUM_RANKS)),
+                    static_cast<Card::Suit>(random_below(rng, NUM_SUITS)));
+    }
+
+    NullSink sink;
+    Hand hand;
+    std::size_t next = 0;
+    auto const deal = [&] {
+        hand.reset();
+        for (int i = 0; i < Config::MAX_STARTING_ROUND; ++i) {
+            hand.add_card(cards[next++ % NUM_CARDS]);
+        }
+    };
+    bench.run("Hand::play_card (10 cards)", PLAYS, [&] {
+        deal();
+        unsigned bits = 0;
+        for (int i = 0; i < PLAYS; ++i) {
+            bits += hand.play_card(cards[next++ % NUM_CARDS], sink).get_bits();
+        }
+        keep(bits);
+    });
+    bench.run("Hand::play_card<10> (10 cards)", PLAYS, [&] {
+        deal();
+        unsigned bits = 0;
+        for (int i = 0; i < PLAYS; ++i) {
+            bits += hand.play_card<Config::MAX_STARTING_ROUND>(cards[next++ % NUM_CARDS], sink).get_bits();
+        }
+        keep(bits);
+    });
+}
+
+void bench_format(Bench& bench) {
+    Hand hand;
+    Rng rng(3);
+    for (int i = 0; i < Config::MAX_STARTING_ROUND; ++i) {
+        hand.add_card(Card(static_cast<Card::Rank>(1 + random_below(rng, NUM_RANKS)),
+                           static_cast<Card::Suit>(random_below(rng, NUM_SUITS))));
+        hand.set_showing(static_cast<size_t>(i), i % 3 != 0);
+    }
+
+    std::string text;
+    bench.run("format Hand (10 cards)", 1, [&] {
+        text.clear();
+        std::format_to(std::back_inserter(text), "{}", hand);
+        keep(text.size());
+    });
+    bench.run("format Hand (10 cards, ASCII suits)", 1, [&] {
+        text.clear();
+        std::format_to(std::back_inserter(text), "{:a}", hand);
+        keep(text.size());
+    });
+}
+
+void bench_rounds(Bench& bench) {
+    std::vector<std::vector<Card>> const orders = make_deck_orders(256);
+    NullSink sink;
+    for (short num_players : { 2, 4 }) {
+        for (short starting_round : { 1, 5, 10 }) {
+            std::size_t next = 0;
+            std::uint64_t seed = 0;
+            std::optional<Game> game;
+            auto const deal = [&] {
+                game.emplace(make_players(num_players, starting_round), starting_round, true, sink, ++seed);
+                game->set_deck_order(orders[next++ % orders.size()]);
+                game->deal(std::vector<short>(num_players, starting_round));
+                game->discard_first_card();
+            };
+            bench.run(std::format("Game::take_turns ({}p, round {})", num_players, starting_round), 1, deal,
+                      [&] { keep(game->take_turns()); });
+        }
+    }
+}
+
+/**
+ * @brief Cost per turn of a round from 10 cards as the table and the shoe grow. Each count of players is dealt from
+ * the smallest shoe that holds the hands and from the largest one.
+ */
+void bench_shoes(Bench& bench) {
+    constexpr int CALIBRATION_ROUNDS = 256;
+    short const starting_round = Config::MAX_STARTING_ROUND;
+    for (short num_players : { 2, 4, 8, 12, 16, 24, 32 }) {
+        short const min_decks = Game::min_decks(num_players, starting_round);
+        for (short num_decks : { min_decks, Config::MAX_DECKS }) {
+            CountingSink sink;
+            std::uint64_t seed = 0;
+            auto const play_round = [&] {
+                Game game(make_players(num_players, starting_round), starting_round, true, sink, ++seed);
+                game.set_num_decks(num_decks);
+                game.deal(std::vector<short>(num_players, starting_round));
+                game.discard_first_card();
+                keep(game.take_turns());
+            };
+
+            // Rounds take a different number of turns at every table size, so time rounds and report per turn
+            for (int i = 0; i < CALIBRATION_ROUNDS; ++i) {
+                play_round();
+            }
+            std::uint64_t const turns_per_round = std::max<std::uint64_t>(1, sink.turns / CALIBRATION_ROUNDS);
+            bench.run(std::format("Game turn ({}p, {} decks)", num_players, num_decks), turns_per_round, play_round);
+        }
+    }
+}
+
+void bench_snapshots(Bench& bench) {
+    NullSink sink;
+    for (short num_players : { 4, 12 }) {
+        Game game(make_players(num_players, Config::MAX_STARTING_ROUND), Config::MAX_STARTING_ROUND, true, sink, 1);
+        game.deal(std::vector<short>(num_players, Config::MAX_STARTING_ROUND));
+        game.discard_first_card();
+        GameSnapshot snapshot {};
+        game.save(snapshot);
+        bench.run(std::format("Game::save + restore ({}p)", num_players), 1, [&] {
+            game.save(snapshot);
+            game.restore(snapshot);
+            keep(snapshot);
+        });
+        bench.run(std::format("serialize_snapshot + deserialize_snapshot ({}p)", num_players), 1, [&] {
+            keep(deserialize_snapshot(serialize_snapshot(snapshot)));
+        });
+    }
+}
+
+void bench_games(Bench& bench) {
+    NullSink sink;
+    for (short num_players : { 1, 2, 3, 4, 8, 12 }) {
+        for (short starting_round = 1; starting_round <= Config::MAX_STARTING_ROUND; ++starting_round) {
+            std::uint64_t seed = 0;
+            bench.run(std::format("Game::play ({}p, round {})", num_players, starting_round), 1, [&] {
+                Game game(make_players(num_players, starting_round), starting_round, true, sink, ++seed);
+                game.play();
+            });
+        }
+    }
+}
+
+/**
+ * @brief Cost of playing a game one step at a time through Game::steps(), alone and with many games interleaved on
+ * one thread, against the same games played with Game::play().
+ */
+void bench_steps(Bench& bench) {
+    constexpr std::size_t INTERLEAVED_GAMES = 1024;
+    constexpr short num_players = 4;
+    NullSink sink;
+    short const starting_round = Config::MAX_STARTING_ROUND;
+    std::uint64_t seed = 0;
+    bench.run(std::format("Game::steps ({}p, round {})", num_players, starting_round), 1, [&] {
+        Game game(make_players(num_players, starting_round), starting_round, true, sink, ++seed);
+        for (GameStep const& step : game.steps()) {
+            keep(step);
+        }
+    });
+
+    seed = 0;
+    bench.run(std::format("Game::steps interleaved ({} games, {}p)", INTERLEAVED_GAMES, num_players),
+              INTERLEAVED_GAMES, [&] {
+                  std::vector<std::unique_ptr<Game>> games;
+                  std::vector<std::generator<GameStep>> generators;
+                  std::vector<std::ranges::iterator_t<std::generator<GameStep>>> steps;
+                  for (std::size_t i = 0; i < INTERLEAVED_GAMES; ++i) {
+                      games.push_back(std::make_unique<Game>(make_players(num_players, starting_round),
+                                                             starting_round, true, sink, ++seed));
+                      generators.push_back(games.back()->steps());
+                      steps.push_back(generators.back().begin());
+                  }
+                  // One step of every live game in turn, as an event loop serving many games would
+                  for (std::size_t live = INTERLEAVED_GAMES; live > 0;) {
+                      live = 0;
+                      for (auto& step : steps) {
+                          if (step != std::default_sentinel) {
+                              keep(*step);
+                              ++step;
+                              ++live;
+                          }
+                      }
+                  }
+              });
+}
+
+/**
+ * @brief Escapes a string for a JSON string literal. Benchmark names only need quotes and backslashes escaped.
+ */
+std::string json_escape(std::string_view text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void write_json(std::string const& path, std::vector<Measurement> const& results) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "w"), &std::fclose);
+    if (!file) {
+        std::cerr << "Cannot open " << path << std::endl;
+        exit(1);
+    }
+    std::println(file.get(), "{{");
+    std::println(file.get(), "  \"compiler\": \"{}\",", json_escape(__VERSION__));
+    std::println(file.get(), "  \"unit\": \"ns/op\",");
+    std::println(file.get(), "  \"benchmarks\": [");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        Measurement const& m = results[i];
+        std::println(file.get(),
+                     "    {{\"name\": \"{}\", \"ops_per_repetition\": {}, \"repetitions\": {}, \"median\": {:.3f}, "
+                     "\"min\": {:.3f}, \"max\": {:.3f}, \"ops_per_second\": {:.0f}}}{}",
+                     json_escape(m.name), m.ops_per_repetition, m.repetitions, m.median_ns, m.min_ns, m.max_ns,
+                     1e9 / m.median_ns, i + 1 < results.size() ? "," : "");
+    }
+    std::println(file.get(), "  ]");
+    std::println(file.get(), "}}");
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " [json_path] [repetitions] [filter]" << std::endl;
+        exit(1);
+    }
+
+    std::string const json_path = argc > 1 ? argv[1] : "";
+    long long const repetitions = argc > 2 ? std::stoll(argv[2]) : 31;
+    std::string const filter = argc > 3 ? argv[3] : "";
+
+    if (repetitions < 1) {
+        std::cerr << "repetitions must be at least 1" << std::endl;
+        exit(1);
+    }
+
+    Bench bench(static_cast<std::size_t>(repetitions), filter);
+    std::println("{:<44} {:>12} {:>12} {:>14}", "benchmark", "median ns", "max ns", "ops/s");
+    bench_deck(bench);
+    bench_hand(bench);
+    bench_format(bench);
+    bench_rounds(bench);
+    bench_shoes(bench);
+    bench_snapshots(bench);
+    bench_games(bench);
+    bench_steps(bench);
+
+    if (!json_path.empty()) {
+        write_json(json_path, bench.get_results());
+    }
+    return 0;
+}
@@ -0,0 +1,271 @@
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+#include "Random.h"
+#include "Stats.h"
+#include "const.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief One connection to the server, playing its games one after another.
+ */
+struct BotSession {
+    int fd = -1;
+    std::uint64_t next_game = 0;
+    std::uint64_t last_game = 0;
+    std::array<std::uint8_t, 2 * Protocol::MAX_FRAME_SIZE> input;
+    std::size_t input_size = 0;
+
+    /**
+     * @brief When the message the session waits for an answer to was sent.
+     */
+    Clock::time_point sent_at;
+};
+
+struct Totals {
+    std::uint64_t games = 0;
+    std::uint64_t wins = 0;
+    std::uint64_t decisions = 0;
+    std::uint64_t errors = 0;
+    QuantileSketch round_trip_us;
+};
+
+char const* error_name(Protocol::Error error) noexcept {
+    switch (error) {
+    case Protocol::Error::BAD_MESSAGE:
+        return "malformed message";
+    case Protocol::Error::BAD_VERSION:
+        return "unsupported protocol version";
+    case Protocol::Error::BAD_TABLE:
+        return "the table cannot be dealt";
+    case Protocol::Error::UNEXPECTED:
+        return "unexpected message";
+    case Protocol::Error::SERVER_FULL:
+        return "server full";
+    }
+    return "unknown error";
+}
+
+void raise_file_limit() noexcept {
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int connect_to(std::string const& path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("The socket path is too long");
+    }
+    std::ranges::copy(path, address.sun_path);
+    // Blocking, so a full accept backlog makes us wait for the server rather than fail
+    int const fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0) {
+        std::string const reason = std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw std::runtime_error("Cannot connect to " + path + ": " + reason);
+    }
+    return fd;
+}
+
+/**
+ * @brief Sends a whole frame; frames are tiny and the server always reads, so a blocking send returns at once.
+ */
+void send_frame(BotSession& session, std::span<std::uint8_t const> frame) {
+    session.sent_at = Clock::now();
+    while (!frame.empty()) {
+        ssize_t const sent = ::send(session.fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0) {
+            throw std::runtime_error(std::string("Cannot send to the server: ") + std::strerror(errno));
+        }
+        frame = frame.subspan(static_cast<std::size_t>(sent));
+    }
+}
+
+/**
+ * @brief Asks for the session's next game, seeded like game next_game of a simulate batch with the same seed.
+ */
+void start_game(BotSession& session, Protocol::Hello hello, std::uint64_t seed) {
+    std::array<std::uint8_t, Protocol::MAX_FRAME_SIZE> frame;
+    hello.seed = stream_seed(seed, session.next_game++);
+    send_frame(session, std::span(frame).first(Protocol::write_hello(frame, hello)));
+}
+
+/**
+ * @brief Answers a message from the server.
+ * @return false once the session is done.
+ */
+bool handle(BotSession& session, Protocol::Frame const& frame, Protocol::Hello const& hello, std::uint64_t seed,
+            Totals& totals) {
+    std::chrono::duration<double, std::micro> const round_trip = Clock::now() - session.sent_at;
+    totals.round_trip_us.add(round_trip.count());
+    std::array<std::uint8_t, Protocol::MAX_FRAME_SIZE> reply;
+    switch (frame.message) {
+    case Protocol::Message::DECISION: {
+        // The greedy rule: take the discard whenever it can be placed
+        Protocol::Decision const decision = Protocol::read_decision(frame);
+        bool const take_discard = decision.hand.card_is_playable(decision.top_discard);
+        ++totals.decisions;
+        send_frame(session, std::span(reply).first(Protocol::write_decide(reply, take_discard)));
+        return true;
+    }
+    case Protocol::Message::GAME_OVER: {
+        Protocol::GameOver const game_over = Protocol::read_game_over(frame);
+        ++totals.games;
+        totals.wins += game_over.rounds[0] == 0 ? 1 : 0;
+        if (session.next_game == session.last_game) {
+            return false;
+        }
+        start_game(session, hello, seed);
+        return true;
+    }
+    case Protocol::Message::ERROR:
+        ++totals.errors;
+        std::cerr << "Server error: " << error_name(Protocol::read_error(frame)) << std::endl;
+        return false;
+    default:
+        throw std::runtime_error("Unexpected message from the server");
+    }
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || argc > 7) {
+        std::cerr << "Usage: " << argv[0]
+                  << " socket_path num_sessions games_per_session [num_players] [starting_round] [seed]" << std::endl;
+        exit(1);
+    }
+
+    std::string const socket_path = argv[1];
+    long long const num_sessions = std::stoll(argv[2]);
+    long long const games_per_session = std::stoll(argv[3]);
+    Protocol::Hello hello;
+    hello.num_players = static_cast<std::uint8_t>(argc > 4 ? std::stoi(argv[4]) : 2);
+    hello.starting_round = static_cast<std::uint8_t>(argc > 5 ? std::stoi(argv[5]) : Config::MAX_STARTING_ROUND);
+    std::uint64_t const seed = argc > 6 ? std::stoull(argv[6]) : std::random_device {}();
+    if (num_sessions < 1 || games_per_session < 1) {
+        std::cerr << "num_sessions and games_per_session must be at least 1" << std::endl;
+        exit(1);
+    }
+    raise_file_limit();
+
+    Totals totals;
+    auto const start = Clock::now();
+    try {
+        int const epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            throw std::runtime_error(std::string("Cannot create an epoll instance: ") + std::strerror(errno));
+        }
+
+        // Session s plays games s * games_per_session onwards, so the games match simulate's for the same seed
+        std::vector<BotSession> sessions(static_cast<std::size_t>(num_sessions));
+        for (std::size_t s = 0; s < sessions.size(); ++s) {
+            BotSession& session = sessions[s];
+            session.fd = connect_to(socket_path);
+            session.next_game = s * static_cast<std::uint64_t>(games_per_session);
+            session.last_game = session.next_game + static_cast<std::uint64_t>(games_per_session);
+            epoll_event event {};
+            event.events = EPOLLIN;
+            event.data.u64 = s;
+            if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, session.fd, &event) != 0) {
+                throw std::runtime_error(std::string("Cannot watch a socket: ") + std::strerror(errno));
+            }
+            start_game(session, hello, seed);
+        }
+
+        std::size_t open = sessions.size();
+        std::array<epoll_event, 256> events;
+        while (open > 0) {
+            int const count = ::epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                throw std::runtime_error(std::string("epoll_wait failed: ") + std::strerror(errno));
+            }
+            for (int i = 0; i < count; ++i) {
+                BotSession& session = sessions[events[i].data.u64];
+                if (session.fd < 0) {
+                    continue;
+                }
+                ssize_t const received = ::recv(session.fd, session.input.data() + session.input_size,
+                                                session.input.size() - session.input_size, MSG_DONTWAIT);
+                if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                    continue;
+                }
+                bool done = received <= 0;
+                if (received > 0) {
+                    session.input_size += static_cast<std::size_t>(received);
+                    std::size_t consumed = 0;
+                    while (!done) {
+                        std::span<std::uint8_t const> const unread
+                            = std::span(session.input).first(session.input_size).subspan(consumed);
+                        std::optional<Protocol::Frame> const frame = Protocol::parse_frame(unread);
+                        if (!frame) {
+                            break;
+                        }
+                        consumed += frame->size;
+                        done = !handle(session, *frame, hello, seed, totals);
+                    }
+                    std::ranges::copy(std::span(session.input).first(session.input_size).subspan(consumed),
+                                      session.input.begin());
+                    session.input_size -= consumed;
+                }
+                if (done) {
+                    ::close(session.fd);
+                    session.fd = -1;
+                    --open;
+                }
+            }
+        }
+        ::close(epoll_fd);
+    } catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+    std::chrono::duration<double> const elapsed = Clock::now() - start;
+
+    double const games = static_cast<double>(totals.games);
+    Interval const win_rate = wilson_interval(totals.wins, totals.games);
+    std::println("Sessions: {}, games: {} in {:.3f}s ({:.0f} games/s, {:.0f} decisions/s)", num_sessions, totals.games,
+                 elapsed.count(), games / elapsed.count(), static_cast<double>(totals.decisions) / elapsed.count());
+    std::println("Bot wins: {} ({:.2f}%, 95% CI {:.2f}%-{:.2f}%)", totals.wins,
+                 games > 0 ? 100.0 * static_cast<double>(totals.wins) / games : 0.0, 100.0 * win_rate.low,
+                 100.0 * win_rate.high);
+    std::println("Round trip: p50 {:.1f}us, p99 {:.1f}us, max {:.1f}us", totals.round_trip_us.quantile(0.5),
+                 totals.round_trip_us.quantile(0.99), totals.round_trip_us.quantile(1.0));
+    if (totals.errors > 0) {
+        std::println("Server errors: {}", totals.errors);
+        return 1;
+    }
+    return 0;
+}
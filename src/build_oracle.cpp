@@ -0,0 +1,32 @@
+#include <iostream>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "Oracle.h"
+#include "const.h"
+
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " oracle_file" << std::endl;
+        exit(1);
+    }
+
+    std::string const path(argv[1]);
+    std::size_t const max_hand_size = Config::MAX_STARTING_ROUND;
+    std::vector<double> const table = solve_expected_turns(max_hand_size);
+    write_oracle(path, table, max_hand_size);
+
+    // Read the file back the way the engine does, as a check that it round-trips
+    ExpectedTurnsOracle const oracle(path);
+    for (std::size_t n = 1; n <= oracle.max_hand_size(); ++n) {
+        if (oracle.expected_turns(n, 0) != table[oracle_index(n, 0)]) {
+            std::cerr << path << " does not read back correctly" << std::endl;
+            return 1;
+        }
+        std::println("Hand of {:2}: {:7.2f} turns expected from all face down", n, oracle.expected_turns(n, 0));
+    }
+    std::println("Wrote {} states to {}", table.size(), path);
+    return 0;
+}
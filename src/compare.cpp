@@ -0,0 +1,110 @@
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "Comparison.h"
+#include "Stats.h"
+#include "Strategy.h"
+
+
+namespace {
+
+Strategy parse_strategy(std::string_view name) {
+    std::optional<Strategy> strategy = strategy_from_name(name);
+    if (!strategy) {
+        std::cerr << "Unknown strategy " << name << std::endl;
+        exit(1);
+    }
+    return *strategy;
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 9) {
+        std::cerr << "Usage: " << argv[0]
+                  << " strategy_a strategy_b [starting_round] [margin] [max_games] [num_threads] [seed]"
+                     " [mirrored|independent]"
+                  << std::endl;
+        exit(1);
+    }
+
+    std::string_view const name_a(argv[1]);
+    std::string_view const name_b(argv[2]);
+    ComparisonConfig config;
+    config.a = parse_strategy(name_a);
+    config.b = parse_strategy(name_b);
+    config.starting_round = argc > 3 ? static_cast<short>(std::stoi(argv[3])) : config.starting_round;
+    config.margin = argc > 4 ? std::stod(argv[4]) : config.margin;
+    if (argc > 5) {
+        long long const max_games = std::stoll(argv[5]);
+        config.max_pairs = max_games > 0 ? static_cast<std::uint64_t>(max_games) / 2 : 0;
+    }
+    config.num_threads = argc > 6 ? static_cast<unsigned>(std::stoul(argv[6])) : 0;
+    config.seed = argc > 7 ? std::stoull(argv[7]) : std::random_device {}();
+    if (argc > 8) {
+        std::string_view const pairing(argv[8]);
+        if (pairing != "mirrored" && pairing != "independent") {
+            std::cerr << "Unknown pairing " << pairing << std::endl;
+            exit(1);
+        }
+        config.mirrored = pairing == "mirrored";
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto last_progress = start;
+    config.on_progress = [&](std::uint64_t pairs, RunningStats const& pair_scores) {
+        auto const now = std::chrono::steady_clock::now();
+        if (now - last_progress >= std::chrono::seconds(1)) {
+            last_progress = now;
+            std::chrono::duration<double> const elapsed = now - start;
+            std::cerr << std::format("{:.1f}s: {} games, {} scores {:.4f}\n", elapsed.count(), 2 * pairs, name_a,
+                                     pair_scores.mean());
+        }
+    };
+
+    ComparisonResult result;
+    try {
+        result = compare_strategies(config);
+    } catch (std::invalid_argument const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t const games = 2 * result.pair_scores.count();
+    std::println("Games played: {} in {:.3f}s ({} pairs, {})", games, elapsed.count(), result.pair_scores.count(),
+                 config.mirrored ? "mirrored" : "independent");
+    Interval const mean = result.pair_scores.mean_interval();
+    std::println("{} score against {}: {:.4f} (95% CI {:.4f}-{:.4f})", name_a, name_b, result.pair_scores.mean(),
+                 mean.low, mean.high);
+    std::println("Wins: {} {}, {} {}", name_a, result.wins_a, name_b, result.wins_b);
+    std::println("Score variance per pair: {:.5f} ({:.5f} for independent games, {:.1f}x fewer games needed)",
+                 result.pair_scores.variance(), result.game_scores.variance() / 2.0, result.variance_reduction());
+    Sprt const bounds(0.5, 0.5 + config.margin, config.alpha, config.beta);
+    std::println("Log-likelihood ratios: {} stronger {:.3g}, {} stronger {:.3g} (bounds {:.3g} and {:.3g})", name_a,
+                 result.llr_a, name_b, result.llr_b, bounds.lower_bound(), bounds.upper_bound());
+
+    switch (result.verdict) {
+    case ComparisonResult::Verdict::A_STRONGER:
+        std::println("Verdict: {} is stronger than {}", name_a, name_b);
+        break;
+    case ComparisonResult::Verdict::B_STRONGER:
+        std::println("Verdict: {} is stronger than {}", name_b, name_a);
+        break;
+    case ComparisonResult::Verdict::NO_DIFFERENCE:
+        std::println("Verdict: neither strategy scores above {:.3f} against the other", 0.5 + config.margin);
+        break;
+    case ComparisonResult::Verdict::UNRESOLVED:
+        std::println("Verdict: unresolved after {} games", games);
+        break;
+    }
+    return 0;
+}
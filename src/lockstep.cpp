@@ -0,0 +1,121 @@
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BatchRunner.h"
+#include "EventSink.h"
+#include "Game.h"
+#include "LockstepEngine.h"
+#include "Player.h"
+#include "Random.h"
+#include "const.h"
+
+namespace {
+
+/**
+ * @brief Replays a game through Game and returns true if it ends exactly as the lockstep engine played it.
+ */
+bool matches_game(LockstepGame const& played, short num_players, short starting_round, std::uint64_t seed) {
+    std::vector<Player> players;
+    for (short i = 0; i < num_players; ++i) {
+        players.push_back(Player_factory("Player " + std::to_string(i + 1), starting_round));
+    }
+    CountingSink counter;
+    Game game(players, starting_round, true, counter, stream_seed(seed, played.index));
+    game.play();
+
+    bool same = counter.rounds == played.rounds && counter.turns == played.turns
+                && counter.reshuffles == played.reshuffles && counter.stalemates == played.stalemates;
+    for (short i = 0; i < num_players; ++i) {
+        same = same && game.get_players()[i].get_round() == played.final_rounds[i];
+    }
+    return same;
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || argc > 7) {
+        std::cerr << "Usage: " << argv[0] << " num_players starting_round num_games [seed] [scalar|avx2] [verify]"
+                  << std::endl;
+        exit(1);
+    }
+
+    int const num_players = std::stoi(argv[1]);
+    int const starting_round = std::stoi(argv[2]);
+    long long const num_games = std::stoll(argv[3]);
+    std::uint64_t const seed = argc > 4 ? std::stoull(argv[4]) : std::random_device {}();
+    std::string const kernel_name = argc > 5 ? argv[5] : "";
+    bool const verify = argc > 6 && std::string(argv[6]) == "verify";
+
+    if (num_games < 1) {
+        std::cerr << "num_games must be at least 1" << std::endl;
+        exit(1);
+    }
+
+    LockstepEngine::Kernel kernel = LockstepEngine::best_kernel();
+    if (kernel_name == "scalar") {
+        kernel = LockstepEngine::Kernel::SCALAR;
+    } else if (kernel_name == "avx2") {
+        kernel = LockstepEngine::Kernel::AVX2;
+    } else if (!kernel_name.empty()) {
+        std::cerr << "Unknown kernel " << kernel_name << std::endl;
+        exit(1);
+    }
+
+    std::optional<LockstepEngine> engine;
+    try {
+        engine.emplace(static_cast<short>(num_players), static_cast<short>(starting_round), seed,
+                       LockstepEngine::DEFAULT_LANES, kernel);
+    } catch (std::invalid_argument const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+
+    std::uint64_t next_game = 0;
+    BatchResult result;
+    std::vector<LockstepGame> played;
+
+    auto const start = std::chrono::steady_clock::now();
+    engine->run(
+        [&]() -> std::optional<std::uint64_t> {
+            if (next_game == static_cast<std::uint64_t>(num_games)) {
+                return std::nullopt;
+            }
+            return next_game++;
+        },
+        [&](LockstepGame const& game) {
+            result.record_game(game.rounds, game.turns, game.reshuffles, game.stalemates,
+                               std::span(game.final_rounds).first(static_cast<std::size_t>(num_players)));
+            if (verify) {
+                played.push_back(game);
+            }
+        });
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::println("Games played: {} in {:.3f}s ({:.0f} games/s, {} kernel)", result.games, elapsed.count(),
+                 static_cast<double>(result.games) / elapsed.count(),
+                 engine->get_kernel() == LockstepEngine::Kernel::AVX2 ? "avx2" : "scalar");
+    print_report(result, static_cast<short>(num_players));
+
+    if (verify) {
+        std::uint64_t mismatches = 0;
+        for (LockstepGame const& game : played) {
+            if (!matches_game(game, static_cast<short>(num_players), static_cast<short>(starting_round), seed)) {
+                if (mismatches == 0) {
+                    std::println("Game {} differs from Game::play", game.index);
+                }
+                ++mismatches;
+            }
+        }
+        std::println("Verified against Game: {} of {} games match", played.size() - mismatches, played.size());
+        return mismatches == 0 ? 0 : 1;
+    }
+    return 0;
+}
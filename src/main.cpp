@@ -1,20 +1,24 @@
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <print>
 #include <string>
 #include <vector>
 
 #include "Card.h"
 #include "Deck.h"
+#include "EventSink.h"
 #include "Game.h"
 #include "Hand.h"
+#include "Logger.h"
+#include "Metrics.h"
 #include "Player.h"
 #include "const.h"
 
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " num_players starting_round shuffle_enabled" << std::endl;
+    if (argc != 4 && argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " num_players starting_round shuffle_enabled [num_games]" << std::endl;
         exit(1);
     }
 
@@ -37,14 +41,61 @@ int main(int argc, char* argv[]) {
         exit(1);
     }
 
-    std::vector<Player*> players;
+    long long num_games = 0;
+    if (argc == 5) {
+        num_games = std::stoll(argv[4]);
+        if (num_games < 1) {
+            std::cerr << "num_games must be at least 1" << std::endl;
+            exit(1);
+        }
+    }
+
+    auto make_players = [&]() {
+        std::vector<Player> players;
+        for (short i = 0; i < num_players; i++) {
+            players.push_back(Player_factory("Player " + std::to_string(i + 1), starting_round));
+        }
+        return players;
+    };
 
-    for (short i = 0; i < num_players; i++) {
-        Player* player = Player_factory("Player " + std::to_string(i + 1), starting_round);
-        players.push_back(player);
+    if (num_games == 0) {
+        // The full play-by-play unless GARBAGE_LOG_LEVEL asks for less
+        std::unique_ptr<Logger> logger;
+        try {
+            logger = Logger::from_environment(Logger::Level::DEBUG);
+        } catch (std::exception const& e) {
+            std::cerr << e.what() << std::endl;
+            exit(1);
+        }
+        TextSink sink(*logger);
+        Game game(make_players(), starting_round, shuffle_enabled, sink);
+        game.play();
+        logger->flush();
+        if (logger->failed()) {
+            std::cerr << "Some of the game's output could not be written" << std::endl;
+            exit(1);
+        }
+        Metrics::dump_if_requested();
+        return 0;
     }
 
-    Game game(players, starting_round, shuffle_enabled);
+    // Headless mode: play every game silently and only report the aggregates.
+    CountingSink sink;
+    for (long long g = 0; g < num_games; ++g) {
+        Game game(make_players(), starting_round, shuffle_enabled, sink);
+        game.play();
+    }
+
+    std::println("Games played: {}", sink.games);
+    std::println("Rounds: {} ({:.2f} per game)", sink.rounds, static_cast<double>(sink.rounds) / sink.games);
+    std::println("Turns: {} ({:.2f} per game)", sink.turns, static_cast<double>(sink.turns) / sink.games);
+    std::println("Discards taken: {}, cards drawn: {}", sink.discards_taken, sink.draws);
+    std::println("Stalemated rounds: {}", sink.stalemates);
+    for (short i = 0; i < num_players; ++i) {
+        std::println("Player {} wins: {} ({:.2f}%)", i + 1, sink.wins[i],
+                     100.0 * static_cast<double>(sink.wins[i]) / sink.games);
+    }
 
+    Metrics::dump_if_requested();
     return 0;
 }
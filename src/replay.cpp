@@ -0,0 +1,191 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "EventSink.h"
+#include "Game.h"
+#include "GameLog.h"
+#include "Logger.h"
+#include "Player.h"
+#include "const.h"
+
+namespace {
+
+/**
+ * @brief Plays a recorded game again with the recorded strategies, dealing the recorded cards in the recorded order
+ * and answering the decisions of external seats as they were answered.
+ */
+void rerun(RecordedGame const& recorded, EventSink& sink) {
+    std::vector<Player> players;
+    for (short i = 0; i < recorded.num_players; ++i) {
+        players.push_back(Player_factory("Player " + std::to_string(i + 1), recorded.starting_round,
+                                         recorded.strategies[static_cast<std::size_t>(i)]));
+    }
+    Game game(players, recorded.starting_round, true, sink);
+    game.set_num_decks(recorded.num_decks);
+    game.set_deck_order(recorded.deck_order);
+    std::size_t next_decision = 0;
+    for (GameStep const& step : game.steps()) {
+        if (step.kind == GameStep::Kind::DECISION) {
+            bool const take_discard = next_decision < recorded.external_decisions.size()
+                && recorded.external_decisions[next_decision];
+            ++next_decision;
+            game.decide(take_discard);
+        }
+    }
+}
+
+int scan(std::span<std::uint8_t const> records) {
+    auto const start = std::chrono::steady_clock::now();
+
+    std::uint64_t games = 0, rounds = 0, turns = 0, draws = 0, discards_taken = 0, plays = 0, stalemates = 0;
+    std::uint64_t num_records = 0;
+    std::array<std::uint64_t, Config::MAX_PLAYER_COUNT> wins {};
+    std::array<short, Config::MAX_PLAYER_COUNT> player_rounds {};
+    short num_players = 0;
+
+    LogCursor cursor(records);
+    LogRecord record;
+    while (cursor.next(record)) {
+        ++num_records;
+        switch (record.event) {
+        case LogEvent::GAME_SETUP:
+            if (record.a < 1 || record.a > Config::MAX_PLAYER_COUNT) {
+                std::cerr << "Log is corrupt at offset " << cursor.offset() << ": a game of " << int { record.a }
+                          << " players" << std::endl;
+                return 1;
+            }
+            num_players = record.a;
+            player_rounds.fill(record.b);
+            break;
+        case LogEvent::STRATEGY:
+            if (record.a >= num_players) {
+                std::cerr << "Log is corrupt at offset " << cursor.offset() << ": a strategy for seat "
+                          << int { record.a } << " in a game of " << num_players << " players" << std::endl;
+                return 1;
+            }
+            break;
+        case LogEvent::TURN:
+            ++turns;
+            break;
+        case LogEvent::TAKE_DISCARD:
+            ++discards_taken;
+            break;
+        case LogEvent::DRAW:
+            ++draws;
+            break;
+        case LogEvent::PLAY:
+            ++plays;
+            break;
+        case LogEvent::STALEMATE:
+            ++stalemates;
+            break;
+        case LogEvent::ROUND_WON:
+            if (record.a >= num_players) {
+                std::cerr << "Log is corrupt at offset " << cursor.offset() << ": seat " << int { record.a }
+                          << " won a round in a game of " << num_players << " players" << std::endl;
+                return 1;
+            }
+            --player_rounds[record.a];
+            break;
+        case LogEvent::ROUND_END:
+            ++rounds;
+            break;
+        case LogEvent::GAME_END:
+            ++games;
+            for (short i = 0; i < num_players; ++i) {
+                if (player_rounds[i] == 0) {
+                    ++wins[i];
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    if (cursor.offset() != records.size()) {
+        std::cerr << "Log is truncated or corrupt at offset " << cursor.offset() << std::endl;
+    }
+
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    std::println("Records: {} in {:.3f}s ({:.0f} records/s)", num_records, elapsed.count(),
+                 static_cast<double>(num_records) / elapsed.count());
+    std::println("Games: {}", games);
+    std::println("Rounds: {}", rounds);
+    std::println("Turns: {}", turns);
+    std::println("Discards taken: {}, cards drawn: {}, cards placed: {}", discards_taken, draws, plays);
+    std::println("Stalemated rounds: {}", stalemates);
+    for (size_t i = 0; i < wins.size(); ++i) {
+        if (wins[i] > 0) {
+            std::println("Player {} wins: {}", i + 1, wins[i]);
+        }
+    }
+    return 0;
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " log_file scan" << std::endl;
+        std::cerr << "       " << argv[0] << " log_file show|verify game_index" << std::endl;
+        exit(1);
+    }
+
+    MappedLog log(argv[1]);
+    std::string const command(argv[2]);
+
+    if (command == "scan") {
+        return scan(log.records());
+    }
+
+    if ((command != "show" && command != "verify") || argc != 4) {
+        std::cerr << "Unknown command " << command << std::endl;
+        exit(1);
+    }
+
+    RecordedGame recorded;
+    std::size_t const index = std::stoull(argv[3]);
+    try {
+        if (!find_recorded_game(log.records(), index, recorded)) {
+            std::cerr << "The log does not contain game " << index << std::endl;
+            exit(1);
+        }
+    } catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+    if (Game::min_decks(static_cast<std::size_t>(recorded.num_players), recorded.starting_round)
+        > recorded.num_decks) {
+        std::cerr << "Game " << index << " of the log is dealt from too few decks" << std::endl;
+        exit(1);
+    }
+
+    if (command == "show") {
+        Logger logger(stdout, Logger::Level::DEBUG);
+        TextSink sink(logger);
+        rerun(recorded, sink);
+        logger.flush();
+        if (logger.failed()) {
+            std::cerr << "Some of the game's output could not be written" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    LogWriter replayed;
+    RecordingSink sink(replayed);
+    rerun(recorded, sink);
+    std::span<std::uint8_t const> const records = replayed.data().subspan(LOG_MAGIC.size() + 1);
+    if (!std::ranges::equal(records, recorded.records)) {
+        std::println("Game {} does not replay identically", index);
+        return 1;
+    }
+    std::println("Game {} replays identically ({} records)", index, records.size());
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <csignal>
+#include <iostream>
+#include <print>
+#include <stdexcept>
+#include <string>
+
+#include <sys/resource.h>
+
+#include "GameServer.h"
+
+namespace {
+
+GameServer* running_server = nullptr;
+
+void request_stop(int) {
+    if (running_server != nullptr) {
+        running_server->stop();
+    }
+}
+
+/**
+ * @brief Raises the limit on open files as far as allowed, since every session holds a socket.
+ */
+void raise_file_limit() noexcept {
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " socket_path [num_threads] [max_sessions]" << std::endl;
+        exit(1);
+    }
+
+    ServerConfig config;
+    config.socket_path = argv[1];
+    config.num_threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1;
+    if (argc > 3) {
+        long long const max_sessions = std::stoll(argv[3]);
+        if (max_sessions < 1 || max_sessions > 0xFFFFFFFFll) {
+            std::cerr << "max_sessions must be between 1 and 4294967295" << std::endl;
+            exit(1);
+        }
+        config.max_sessions = static_cast<std::uint32_t>(max_sessions);
+    }
+    raise_file_limit();
+
+    try {
+        GameServer server(config);
+        running_server = &server;
+        std::signal(SIGINT, request_stop);
+        std::signal(SIGTERM, request_stop);
+        std::println(stderr, "Listening on {}", config.socket_path);
+        server.run();
+        running_server = nullptr;
+
+        ServerStats const stats = server.get_stats();
+        std::println("Sessions: {}, games started: {}, games finished: {}, decisions: {}", stats.sessions_opened,
+                     stats.games_started, stats.games_finished, stats.decisions);
+    } catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+    return 0;
+}
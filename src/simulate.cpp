@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <random>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "BatchRunner.h"
+#include "Game.h"
+#include "Metrics.h"
+#include "const.h"
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 5 || argc > 10) {
+        std::cerr << "Usage: " << argv[0]
+                  << " num_players starting_round shuffle_enabled num_games [num_threads] [seed] [record_path]"
+                     " [strategies] [num_decks]"
+                  << std::endl;
+        exit(1);
+    }
+
+    BatchConfig config;
+
+    int num_players = std::stoi(argv[1]);
+
+    int starting_round = std::stoi(argv[2]);
+
+    std::string shuffle_enabled_in(argv[3]);
+    std::transform(shuffle_enabled_in.begin(), shuffle_enabled_in.end(), shuffle_enabled_in.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    config.shuffle_enabled = (shuffle_enabled_in == "true" || shuffle_enabled_in == "1" || shuffle_enabled_in == "t");
+
+    long long num_games = std::stoll(argv[4]);
+
+    if (num_players < 1 || num_players > Config::MAX_PLAYER_COUNT) {
+        std::cerr << "num_players must be between 1 and " << Config::MAX_PLAYER_COUNT << std::endl;
+        exit(1);
+    }
+
+    if (starting_round < 1 || starting_round > Config::MAX_STARTING_ROUND) {
+        std::cerr << "starting_round must be between 1 and " << Config::MAX_STARTING_ROUND << std::endl;
+        exit(1);
+    }
+
+    if (num_games < 1) {
+        std::cerr << "num_games must be at least 1" << std::endl;
+        exit(1);
+    }
+
+    config.num_players = static_cast<short>(num_players);
+    config.starting_round = static_cast<short>(starting_round);
+    config.num_games = static_cast<std::uint64_t>(num_games);
+    config.num_threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 0;
+    config.seed = argc > 6 ? std::stoull(argv[6]) : std::random_device {}();
+    config.record_path = argc > 7 ? argv[7] : "";
+
+    if (argc > 8) {
+        std::string_view names(argv[8]);
+        while (!names.empty()) {
+            std::size_t const comma = names.find(',');
+            std::string_view const name = names.substr(0, comma);
+            names = comma == std::string_view::npos ? std::string_view {} : names.substr(comma + 1);
+            std::optional<Strategy> strategy = strategy_from_name(name);
+            if (!strategy) {
+                std::cerr << "Unknown strategy " << name << std::endl;
+                exit(1);
+            }
+            config.strategies.push_back(*strategy);
+        }
+        if (config.strategies.size() > static_cast<std::size_t>(num_players)) {
+            std::cerr << "More strategies than players" << std::endl;
+            exit(1);
+        }
+    }
+
+    if (argc > 9) {
+        int const num_decks = std::stoi(argv[9]);
+        short const min_decks = Game::min_decks(config.num_players, config.starting_round);
+        if (num_decks < min_decks || num_decks > Config::MAX_DECKS) {
+            std::cerr << "num_decks must be between " << min_decks << " and " << Config::MAX_DECKS << std::endl;
+            exit(1);
+        }
+        config.num_decks = static_cast<short>(num_decks);
+    }
+
+    // GARBAGE_CHECK_ALLOCATIONS=1 fails the run if any game allocates once its worker is warmed up
+    if (char const* check = std::getenv("GARBAGE_CHECK_ALLOCATIONS"); check != nullptr && *check != '\0') {
+        config.check_allocations = std::string_view(check) != "0";
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    BatchResult result;
+    try {
+        result = run_batch(config);
+    } catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::println("Games played: {} in {:.3f}s ({:.0f} games/s)", result.games, elapsed.count(),
+                 static_cast<double>(result.games) / elapsed.count());
+    print_report(result, config.num_players);
+
+    Metrics::dump_if_requested();
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Stats.h"
+#include "Strategy.h"
+#include "Tournament.h"
+
+
+namespace {
+
+/**
+ * @brief Splits a comma-separated list.
+ */
+std::vector<std::string_view> split(std::string_view text) {
+    std::vector<std::string_view> fields;
+    while (!text.empty()) {
+        std::size_t const comma = text.find(',');
+        fields.push_back(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view {} : text.substr(comma + 1);
+    }
+    return fields;
+}
+
+void print_standings(EloRatings const& ratings, std::vector<Entrant> const& entrants) {
+    std::vector<std::size_t> ranking(ratings.size());
+    std::iota(ranking.begin(), ranking.end(), std::size_t { 0 });
+    std::ranges::stable_sort(ranking, std::greater {}, [&](std::size_t e) { return ratings.rating(e); });
+
+    std::println("{:<4} {:<24} {:>8} {:>10} {:>10} {:>24}", "rank", "entrant", "elo", "games", "wins",
+                 "win rate (95% CI)");
+    for (std::size_t rank = 0; rank < ranking.size(); ++rank) {
+        std::size_t const e = ranking[rank];
+        Interval const rate = wilson_interval(ratings.wins(e), ratings.games(e));
+        double const games = static_cast<double>(ratings.games(e));
+        std::println("{:<4} {:<24} {:>8.1f} {:>10} {:>10} {:>8.2f}% ({:.2f}-{:.2f}%)", rank + 1, entrants[e].name,
+                     ratings.rating(e), ratings.games(e), ratings.wins(e),
+                     games > 0 ? 100.0 * static_cast<double>(ratings.wins(e)) / games : 0.0, 100.0 * rate.low,
+                     100.0 * rate.high);
+    }
+}
+
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || argc > 8) {
+        std::cerr << "Usage: " << argv[0]
+                  << " round-robin|random strategies num_games [starting_rounds] [players_per_match] [num_threads]"
+                     " [seed]"
+                  << std::endl;
+        exit(1);
+    }
+
+    TournamentConfig config;
+    std::string_view const format(argv[1]);
+    if (format == "round-robin") {
+        config.format = TournamentConfig::Format::ROUND_ROBIN;
+    } else if (format == "random") {
+        config.format = TournamentConfig::Format::RANDOM_PAIRING;
+    } else {
+        std::cerr << "Unknown tournament format " << format << std::endl;
+        exit(1);
+    }
+
+    for (std::string_view const name : split(argv[2])) {
+        std::optional<Strategy> strategy = strategy_from_name(name);
+        if (!strategy) {
+            std::cerr << "Unknown strategy " << name << std::endl;
+            exit(1);
+        }
+        config.entrants.push_back({ std::string(name), *strategy });
+    }
+
+    long long const num_games = std::stoll(argv[3]);
+    if (num_games < 1) {
+        std::cerr << "num_games must be at least 1" << std::endl;
+        exit(1);
+    }
+    config.games_per_pairing = static_cast<std::uint64_t>(num_games);
+    config.num_matches = static_cast<std::uint64_t>(num_games);
+
+    if (argc > 4) {
+        config.starting_rounds.clear();
+        for (std::string_view const round : split(argv[4])) {
+            config.starting_rounds.push_back(static_cast<short>(std::stoi(std::string(round))));
+        }
+    }
+    config.players_per_match = argc > 5 ? static_cast<short>(std::stoi(argv[5])) : 2;
+    config.num_threads = argc > 6 ? static_cast<unsigned>(std::stoul(argv[6])) : 0;
+    config.seed = argc > 7 ? std::stoull(argv[7]) : std::random_device {}();
+
+    auto const start = std::chrono::steady_clock::now();
+    config.on_progress = [&](std::uint64_t rated, EloRatings const& ratings) {
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        std::size_t leader = 0;
+        for (std::size_t e = 1; e < ratings.size(); ++e) {
+            leader = ratings.rating(e) > ratings.rating(leader) ? e : leader;
+        }
+        std::cerr << std::format("{:.1f}s: {} games rated, {} leads at {:.1f}\n", elapsed.count(), rated,
+                                 config.entrants[leader].name, ratings.rating(leader));
+    };
+
+    std::optional<TournamentResult> result;
+    try {
+        // Progress about ten times over the run
+        std::uint64_t const total = config.format == TournamentConfig::Format::ROUND_ROBIN
+                                        ? config.games_per_pairing * config.starting_rounds.size()
+                                              * config.entrants.size() * (config.entrants.size() - 1) / 2
+                                        : config.num_matches;
+        config.progress_interval = std::max<std::uint64_t>(1, total / 10);
+        result = run_tournament(config);
+    } catch (std::invalid_argument const& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::println("Games played: {} in {:.3f}s ({:.0f} games/s, {} stolen)", result->matches, elapsed.count(),
+                 static_cast<double>(result->matches) / elapsed.count(), result->steals);
+    print_standings(result->ratings, config.entrants);
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdio>
+#include <print>
+#include <source_location>
+
+/**
+ * @brief Minimal assertions for the test programs in tests/. A failed CHECK reports where it failed and the test
+ * carries on, so one run lists every broken expectation; Check::result() turns the tally into the exit status.
+ */
+namespace Check {
+inline int failures = 0;
+
+/**
+ * @brief Records a failure if the condition does not hold.
+ * @param condition The checked condition.
+ * @param text The condition as written, for the report.
+ * @param where The location of the check.
+ */
+inline void expect(bool condition, char const* text, std::source_location where = std::source_location::current()) {
+    if (!condition) {
+        ++failures;
+        std::println(stderr, "{}:{}: CHECK({}) failed", where.file_name(), where.line(), text);
+    }
+}
+
+/**
+ * @brief Returns the exit status of a test program: 0 if every check held, 1 otherwise.
+ */
+inline int result() noexcept {
+    return failures == 0 ? 0 : 1;
+}
+}
+
+#define CHECK(condition) Check::expect(static_cast<bool>(condition), #condition)
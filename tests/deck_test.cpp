@@ -0,0 +1,80 @@
+#include <cstddef>
+#include <vector>
+
+#include "Card.h"
+#include "Check.h"
+#include "Deck.h"
+
+namespace {
+/**
+ * @brief Returns true if both cards are the same card, not just the same rank.
+ */
+bool same_card(Card const& lhs, Card const& rhs) noexcept {
+    return lhs.get_bits() == rhs.get_bits();
+}
+
+/**
+ * @brief Deals the given number of cards from an unshuffled deck and discards the first few of them in the order
+ * dealt, so the last one discarded is the top of the discard pile.
+ * @return The cards dealt, in order.
+ */
+std::vector<Card> deal_and_discard(Deck& deck, int num_dealt, int num_discarded) {
+    std::vector<Card> dealt;
+    for (int i = 0; i < num_dealt; ++i) {
+        dealt.push_back(deck.deal_one());
+    }
+    for (int i = 0; i < num_discarded; ++i) {
+        deck.discard(dealt[static_cast<std::size_t>(i)]);
+    }
+    return dealt;
+}
+}
+
+int main() {
+    // With the draw pile used up, the recycled discards are dealt newest first and the top discard stays put
+    {
+        Deck deck(1);
+        std::vector<Card> const dealt = deal_and_discard(deck, deck.get_shoe_size(), 5);
+        CHECK(deck.empty());
+        deck.reset();
+        CHECK(same_card(deck.peek_discard(), dealt[4]));
+        CHECK(deck.discard_size() == 1);
+        CHECK(deck.size() == 4);
+        for (int i = 3; i >= 0; --i) {
+            CHECK(same_card(deck.deal_one(), dealt[static_cast<std::size_t>(i)]));
+        }
+        CHECK(deck.empty());
+    }
+
+    // Recycled discards go underneath whatever is left of the draw pile
+    {
+        Deck deck(1);
+        Deck untouched(1);
+        std::vector<Card> const dealt = deal_and_discard(deck, 10, 6);
+        for (int i = 0; i < 10; ++i) {
+            untouched.deal_one();
+        }
+        int const remaining = deck.size();
+        deck.reset();
+        CHECK(deck.size() == remaining + 5);
+        for (int i = 0; i < remaining; ++i) {
+            CHECK(same_card(deck.deal_one(), untouched.deal_one()));
+        }
+        for (int i = 4; i >= 0; --i) {
+            CHECK(same_card(deck.deal_one(), dealt[static_cast<std::size_t>(i)]));
+        }
+        CHECK(deck.empty());
+        CHECK(same_card(deck.peek_discard(), dealt[5]));
+    }
+
+    // A reset with only the top card in the discard pile changes nothing
+    {
+        Deck deck(1);
+        deal_and_discard(deck, 3, 1);
+        int const remaining = deck.size();
+        deck.reset();
+        CHECK(deck.size() == remaining);
+        CHECK(deck.discard_size() == 1);
+    }
+    return Check::result();
+}
@@ -0,0 +1,163 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Card.h"
+#include "Check.h"
+#include "Hand.h"
+#include "Protocol.h"
+
+namespace {
+using Bytes = std::vector<std::uint8_t>;
+
+bool throws(auto&& parse) {
+    try {
+        parse();
+    } catch (std::runtime_error const&) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Builds a frame by hand: tag, length byte and payload, with the length taken from the payload.
+ */
+Bytes frame_of(Protocol::Message message, Bytes const& payload) {
+    Bytes bytes { static_cast<std::uint8_t>(message), static_cast<std::uint8_t>(payload.size()) };
+    bytes.insert(bytes.end(), payload.begin(), payload.end());
+    return bytes;
+}
+
+/**
+ * @brief Parses a buffer that must hold a whole frame. The frame points into the buffer.
+ */
+Protocol::Frame whole_frame(Bytes const& bytes) {
+    std::optional<Protocol::Frame> const frame = Protocol::parse_frame(bytes);
+    if (!frame) {
+        throw std::logic_error("The test frame is incomplete");
+    }
+    return *frame;
+}
+
+std::uint8_t bits(Card::Rank rank, Card::Suit suit) noexcept {
+    return Card(rank, suit).get_bits();
+}
+}
+
+int main() {
+    using Protocol::Message;
+
+    // A frame cut short anywhere is not there yet, whatever the payload would be
+    {
+        std::array<std::uint8_t, Protocol::MAX_FRAME_SIZE> out {};
+        std::size_t const size = Protocol::write_hello(out, Protocol::Hello {});
+        std::span<std::uint8_t const> const written(out.data(), size);
+        for (std::size_t cut = 0; cut < size; ++cut) {
+            CHECK(!Protocol::parse_frame(written.first(cut)));
+        }
+        std::optional<Protocol::Frame> const frame = Protocol::parse_frame(written);
+        CHECK(frame && frame->size == size && frame->message == Message::HELLO);
+    }
+
+    // Only the first of two frames in a row is parsed, and its size says where the next one starts
+    {
+        std::array<std::uint8_t, 2 * Protocol::MAX_FRAME_SIZE> out {};
+        std::size_t const first = Protocol::write_decide(out, true);
+        std::size_t const second = Protocol::write_error(std::span(out).subspan(first), Protocol::Error::BAD_TABLE);
+        std::span<std::uint8_t const> const bytes(out.data(), first + second);
+        std::optional<Protocol::Frame> const decide = Protocol::parse_frame(bytes);
+        CHECK(decide && decide->message == Message::DECIDE && decide->size == first);
+        CHECK(decide && Protocol::read_decide(*decide));
+        std::optional<Protocol::Frame> const error = Protocol::parse_frame(bytes.subspan(first));
+        CHECK(error && Protocol::read_error(*error) == Protocol::Error::BAD_TABLE);
+    }
+
+    // Unknown tags and oversized payloads are refused from the header alone, before the payload arrives
+    {
+        CHECK(throws([] { Protocol::parse_frame(Bytes { static_cast<std::uint8_t>(Message::COUNT), 0 }); }));
+        CHECK(throws([] { Protocol::parse_frame(Bytes { 0xFF, 1, 0 }); }));
+        Bytes const oversized { static_cast<std::uint8_t>(Message::DECIDE), Protocol::MAX_PAYLOAD + 1 };
+        CHECK(throws([&] { Protocol::parse_frame(oversized); }));
+        Bytes largest(Protocol::MAX_FRAME_SIZE, 0);
+        largest[0] = static_cast<std::uint8_t>(Message::DECIDE);
+        largest[1] = Protocol::MAX_PAYLOAD;
+        std::optional<Protocol::Frame> const frame = Protocol::parse_frame(largest);
+        CHECK(frame && frame->payload.size() == Protocol::MAX_PAYLOAD);
+    }
+
+    // Every message reads back as written
+    {
+        std::array<std::uint8_t, Protocol::MAX_FRAME_SIZE> out {};
+        auto const written = [&](std::size_t size) { return Bytes(out.data(), out.data() + size); };
+
+        Protocol::Hello const hello { Protocol::VERSION, 4, 7, 0x0123456789ABCDEFull };
+        Bytes const hello_bytes = written(Protocol::write_hello(out, hello));
+        Protocol::Hello const hello_read = Protocol::read_hello(whole_frame(hello_bytes));
+        CHECK(hello_read.version == hello.version && hello_read.num_players == 4 && hello_read.starting_round == 7);
+        CHECK(hello_read.seed == hello.seed);
+
+        Protocol::Decision decision;
+        decision.round = 3;
+        decision.top_discard = Card(Card::Rank::QUEEN, Card::Suit::HEARTS);
+        decision.hand.add_card(Card(Card::Rank::ACE, Card::Suit::CLUBS));
+        decision.hand.add_card(Card(Card::Rank::NINE, Card::Suit::SPADES));
+        decision.hand.add_card(Card(Card::Rank::THREE, Card::Suit::DIAMONDS));
+        decision.hand.set_showing(2, true);
+        Bytes const decision_bytes = written(Protocol::write_decision(out, decision));
+        Protocol::Decision const decision_read = Protocol::read_decision(whole_frame(decision_bytes));
+        CHECK(decision_read.round == 3);
+        CHECK(decision_read.top_discard.get_bits() == decision.top_discard.get_bits());
+        CHECK(decision_read.hand.size() == 3 && decision_read.hand.get_showing_mask() == 0b100);
+        for (std::size_t i = 0; i < 3; ++i) {
+            CHECK(decision_read.hand.get_card(i).get_bits() == decision.hand.get_card(i).get_bits());
+        }
+
+        Protocol::GameOver game_over;
+        game_over.num_players = Config::MAX_PLAYER_COUNT;
+        game_over.rounds[Config::MAX_PLAYER_COUNT - 1] = 9;
+        Bytes const game_over_bytes = written(Protocol::write_game_over(out, game_over));
+        Protocol::GameOver const game_over_read = Protocol::read_game_over(whole_frame(game_over_bytes));
+        CHECK(game_over_read.num_players == game_over.num_players && game_over_read.rounds == game_over.rounds);
+    }
+
+    // Payloads of the wrong length or with impossible contents are malformed
+    {
+        auto const rejects = [](auto read, Message message, Bytes const& payload) {
+            Bytes const bytes = frame_of(message, payload);
+            Protocol::Frame const frame = whole_frame(bytes);
+            return throws([&] { read(frame); });
+        };
+        CHECK(rejects(Protocol::read_hello, Message::HELLO, Bytes(10, 0)));
+        CHECK(rejects(Protocol::read_hello, Message::HELLO, Bytes(12, 0)));
+        CHECK(rejects(Protocol::read_decide, Message::DECIDE, Bytes {}));
+        CHECK(rejects(Protocol::read_decide, Message::DECIDE, Bytes { 1, 0 }));
+        CHECK(rejects(Protocol::read_error, Message::ERROR, Bytes {}));
+
+        std::uint8_t const ace = bits(Card::Rank::ACE, Card::Suit::SPADES);
+        std::uint8_t const two = bits(Card::Rank::TWO, Card::Suit::HEARTS);
+        CHECK(!rejects(Protocol::read_decision, Message::DECISION, Bytes { 1, ace, 0, 0, 1, two }));
+        CHECK(rejects(Protocol::read_decision, Message::DECISION, Bytes { 1, ace, 0, 0 }));
+        // A hand size that disagrees with the cards sent
+        CHECK(rejects(Protocol::read_decision, Message::DECISION, Bytes { 1, ace, 0, 0, 2, two }));
+        CHECK(rejects(Protocol::read_decision, Message::DECISION, Bytes { 1, ace, 0, 0, 0, two }));
+        // A hand larger than any round deals
+        Bytes too_many { 1, ace, 0, 0, Config::MAX_STARTING_ROUND + 1 };
+        too_many.resize(too_many.size() + Config::MAX_STARTING_ROUND + 1, two);
+        CHECK(rejects(Protocol::read_decision, Message::DECISION, too_many));
+        // Cards of no rank
+        CHECK(rejects(Protocol::read_decision, Message::DECISION, Bytes { 1, 0, 0, 0, 1, two }));
+        CHECK(rejects(Protocol::read_decision, Message::DECISION, Bytes { 1, ace, 0, 0, 1, 0x0E }));
+
+        CHECK(rejects(Protocol::read_game_over, Message::GAME_OVER, Bytes {}));
+        CHECK(rejects(Protocol::read_game_over, Message::GAME_OVER, Bytes { 2, 0 }));
+        CHECK(rejects(Protocol::read_game_over, Message::GAME_OVER, Bytes { 1, 0, 0 }));
+        Bytes too_many_seats(Config::MAX_PLAYER_COUNT + 2, 0);
+        too_many_seats[0] = Config::MAX_PLAYER_COUNT + 1;
+        CHECK(rejects(Protocol::read_game_over, Message::GAME_OVER, too_many_seats));
+    }
+    return Check::result();
+}
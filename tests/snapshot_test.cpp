@@ -0,0 +1,194 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "EventSink.h"
+#include "Game.h"
+#include "GameSnapshot.h"
+#include "Player.h"
+#include "SearchStrategy.h"
+
+namespace {
+/**
+ * @brief Seats a greedy player, a search player and, if asked, a player whose decisions come from outside.
+ */
+std::vector<Player> make_players(short starting_round, bool with_external) {
+    std::vector<Player> players;
+    players.push_back(Player_factory("Greedy", starting_round));
+    SearchStrategy search;
+    search.rollouts = 8;
+    search.seed = 5;
+    players.push_back(Player_factory("Search", starting_round, search));
+    if (with_external) {
+        players.push_back(Player_factory("External", starting_round, ExternalStrategy {}));
+    }
+    return players;
+}
+
+/**
+ * @brief Answers a DECISION step the way an outside player would: take the discard if it can be placed.
+ */
+void answer(Game& game, GameStep const& step) {
+    Hand const& hand = game.get_players()[step.seat].get_hand();
+    game.decide(hand.card_is_playable(game.get_deck().peek_discard()));
+}
+
+bool same_step(GameStep const& lhs, GameStep const& rhs) noexcept {
+    return lhs.kind == rhs.kind && lhs.seat == rhs.seat && lhs.took_discard == rhs.took_discard
+           && lhs.completed == rhs.completed;
+}
+
+bool same_snapshot(GameSnapshot const& lhs, GameSnapshot const& rhs) noexcept {
+    return std::memcmp(&lhs, &rhs, sizeof(GameSnapshot)) == 0;
+}
+
+/**
+ * @brief A game played through steps(), with a snapshot taken at every step before GAME_OVER.
+ */
+struct Recording {
+    std::vector<GameStep> steps;
+    std::vector<GameSnapshot> snapshots;
+    GameSnapshot end {};
+};
+
+Recording record(short starting_round, bool with_external, std::uint64_t seed) {
+    NullSink sink;
+    Game game(make_players(starting_round, with_external), starting_round, true, sink, seed);
+    Recording recording;
+    for (GameStep const& step : game.steps()) {
+        recording.steps.push_back(step);
+        if (step.kind == GameStep::Kind::GAME_OVER) {
+            break;
+        }
+        GameSnapshot snapshot {};
+        game.save(snapshot);
+        // Through the file format, so every saved state also passes its checks
+        recording.snapshots.push_back(deserialize_snapshot(serialize_snapshot(snapshot)));
+        if (step.kind == GameStep::Kind::DECISION) {
+            answer(game, step);
+        }
+    }
+    game.save(recording.end);
+    return recording;
+}
+
+/**
+ * @brief Restores the snapshot taken at one step into a fresh game and checks that it plays on with the same steps
+ * to the same end.
+ */
+void check_resume(Recording const& recording, std::size_t at, short starting_round, bool with_external,
+                  std::uint64_t seed) {
+    NullSink sink;
+    Game game(make_players(starting_round, with_external), starting_round, true, sink, seed + 1);
+    game.restore(recording.snapshots[at]);
+    // A game saved at a DECISION step asks for that decision again
+    std::size_t next = recording.steps[at].kind == GameStep::Kind::DECISION ? at : at + 1;
+    bool matched = true;
+    for (GameStep const& step : game.resume()) {
+        matched = matched && next < recording.steps.size() && same_step(step, recording.steps[next]);
+        ++next;
+        if (step.kind == GameStep::Kind::DECISION) {
+            answer(game, step);
+        }
+    }
+    CHECK(matched);
+    CHECK(next == recording.steps.size());
+    GameSnapshot end {};
+    game.save(end);
+    CHECK(same_snapshot(end, recording.end));
+}
+
+/**
+ * @brief Restores the snapshot taken at one step and finishes the game with play_round() instead of steps.
+ */
+void check_play_rounds(Recording const& recording, std::size_t at, short starting_round, std::uint64_t seed) {
+    NullSink sink;
+    Game game(make_players(starting_round, false), starting_round, true, sink, seed + 1);
+    game.restore(recording.snapshots[at]);
+    while (game.play_round());
+    game.print_scores();
+    GameSnapshot end {};
+    game.save(end);
+    CHECK(same_snapshot(end, recording.end));
+}
+
+bool rejected(GameSnapshot const& snapshot) {
+    try {
+        deserialize_snapshot(serialize_snapshot(snapshot));
+    } catch (std::runtime_error const&) {
+        return true;
+    }
+    return false;
+}
+}
+
+int main() {
+    // Saved at any step, mid-round or between rounds, a game restored elsewhere plays on exactly as the original
+    for (std::uint64_t seed : { 1, 2, 3 }) {
+        short const starting_round = 5;
+        Recording const with_external = record(starting_round, true, seed);
+        CHECK(with_external.snapshots.size() > 10);
+        for (std::size_t at = 0; at < with_external.snapshots.size(); at += 7) {
+            check_resume(with_external, at, starting_round, true, seed);
+        }
+
+        Recording const among_strategies = record(starting_round, false, seed);
+        for (std::size_t at = 0; at < among_strategies.snapshots.size(); at += 11) {
+            check_resume(among_strategies, at, starting_round, false, seed);
+            check_play_rounds(among_strategies, at, starting_round, seed);
+        }
+    }
+
+    // Snapshots that do not add up are refused
+    Recording const recording = record(4, false, 9);
+    GameSnapshot const good = recording.snapshots[recording.snapshots.size() / 2];
+    CHECK(!rejected(good));
+    {
+        // A card face up beyond the end of the hand
+        GameSnapshot bad = good;
+        Hand& hand = bad.hands[0];
+        Hand face_up = hand;
+        face_up.set_showing(0, !hand.is_showing(0));
+        auto* bytes = reinterpret_cast<unsigned char*>(&hand);
+        auto const* changed = reinterpret_cast<unsigned char const*>(&face_up);
+        std::size_t offset = 0;
+        while (offset < sizeof(Hand) && bytes[offset] == changed[offset]) {
+            ++offset;
+        }
+        CHECK(offset < sizeof(Hand));
+        bytes[offset] = static_cast<unsigned char>(bytes[offset] | 0x80u);
+        CHECK(hand.size() < 8);
+        CHECK(rejected(bad));
+    }
+    {
+        // A card the tracker has lost count of
+        GameSnapshot bad = good;
+        ++bad.tracker.unseen_by_rank[1];
+        ++bad.tracker.unseen_count;
+        CHECK(rejected(bad));
+    }
+    {
+        // A discard pile that does not match the tracker's counts
+        GameSnapshot bad = good;
+        ++bad.tracker.discarded_by_rank[2];
+        --bad.tracker.unseen_by_rank[2];
+        --bad.tracker.unseen_count;
+        CHECK(rejected(bad));
+    }
+    {
+        // A seat that is not at the table
+        GameSnapshot bad = good;
+        bad.seat = static_cast<std::uint8_t>(bad.num_players);
+        CHECK(rejected(bad));
+    }
+    {
+        GameSnapshot bad = good;
+        bad.completed = 1u << bad.num_players;
+        CHECK(rejected(bad));
+    }
+    return Check::result();
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Check.h"
+#include "Random.h"
+#include "Stats.h"
+
+namespace {
+/**
+ * @brief Returns true if two results of the same computation agree up to rounding.
+ */
+bool close(double lhs, double rhs) noexcept {
+    return std::abs(lhs - rhs) <= 1e-9 * std::max({ 1.0, std::abs(lhs), std::abs(rhs) });
+}
+
+/**
+ * @brief Values spread over several orders of magnitude, with zeros and repeats, like the turns of many games.
+ */
+std::vector<double> make_values(std::size_t count) {
+    Rng rng(42);
+    std::vector<double> values;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t const draw = random_below(rng, 1000);
+        values.push_back(draw < 50 ? 0.0 : std::pow(1.01, static_cast<double>(draw)));
+    }
+    return values;
+}
+
+RunningStats stats_of(std::vector<double> const& values, std::size_t begin, std::size_t end) {
+    RunningStats stats;
+    for (std::size_t i = begin; i < end; ++i) {
+        stats.add(values[i]);
+    }
+    return stats;
+}
+
+/**
+ * @brief Returns true if constructing the test with these parameters is refused.
+ */
+bool refused(double mu0, double mu1, double alpha, double beta) {
+    try {
+        Sprt(mu0, mu1, alpha, beta);
+    } catch (std::invalid_argument const&) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Feeds a test scores of 0 and 1 with the given share of ones, one at a time, and checks that every decision
+ * follows the log-likelihood ratio and the bounds.
+ * @return The first decision other than CONTINUE, or CONTINUE if there was none within max_observations.
+ */
+Sprt::Decision run(Sprt const& test, double share, int max_observations) {
+    Rng rng(7);
+    RunningStats scores;
+    for (int i = 0; i < max_observations; ++i) {
+        scores.add(random_below(rng, 1000) < share * 1000.0 ? 1.0 : 0.0);
+        Sprt::Decision const decision = test.decide(scores);
+        double const ratio = test.llr(scores);
+        Sprt::Decision const expected = scores.count() < 2         ? Sprt::Decision::CONTINUE
+                                        : ratio >= test.upper_bound() ? Sprt::Decision::ACCEPT_H1
+                                        : ratio <= test.lower_bound() ? Sprt::Decision::ACCEPT_H0
+                                                                      : Sprt::Decision::CONTINUE;
+        CHECK(decision == expected);
+        if (decision != Sprt::Decision::CONTINUE) {
+            return decision;
+        }
+    }
+    return Sprt::Decision::CONTINUE;
+}
+
+QuantileSketch sketch_of(std::vector<double> const& values, std::size_t begin, std::size_t end) {
+    QuantileSketch sketch;
+    for (std::size_t i = begin; i < end; ++i) {
+        sketch.add(values[i]);
+    }
+    return sketch;
+}
+}
+
+int main() {
+    std::vector<double> const values = make_values(10000);
+    RunningStats const single_pass = stats_of(values, 0, values.size());
+    QuantileSketch const single_sketch = sketch_of(values, 0, values.size());
+
+    // Merging the summaries of the parts gives the summary of the whole, however the values are split
+    for (std::size_t parts : { 1, 2, 3, 7, 64 }) {
+        RunningStats merged;
+        QuantileSketch merged_sketch;
+        for (std::size_t p = parts; p-- > 0;) {
+            std::size_t const begin = values.size() * p / parts;
+            std::size_t const end = values.size() * (p + 1) / parts;
+            merged.merge(stats_of(values, begin, end));
+            merged_sketch.merge(sketch_of(values, begin, end));
+        }
+        CHECK(merged.count() == single_pass.count());
+        CHECK(close(merged.mean(), single_pass.mean()));
+        CHECK(close(merged.variance(), single_pass.variance()));
+        CHECK(merged.min() == single_pass.min());
+        CHECK(merged.max() == single_pass.max());
+        CHECK(merged_sketch.count() == single_sketch.count());
+        for (double q : { 0.0, 0.01, 0.25, 0.5, 0.9, 0.99, 1.0 }) {
+            CHECK(merged_sketch.quantile(q) == single_sketch.quantile(q));
+        }
+    }
+
+    // Empty summaries change nothing on either side of a merge
+    {
+        RunningStats stats = single_pass;
+        stats.merge(RunningStats {});
+        CHECK(stats.count() == single_pass.count() && stats.mean() == single_pass.mean());
+        RunningStats empty;
+        empty.merge(single_pass);
+        CHECK(empty.count() == single_pass.count() && empty.variance() == single_pass.variance());
+        CHECK(RunningStats {}.mean() == 0.0 && RunningStats {}.variance() == 0.0);
+        CHECK(QuantileSketch {}.quantile(0.5) == 0.0);
+    }
+
+    // Every quantile is within the relative accuracy of the exact one
+    {
+        std::vector<double> sorted = values;
+        std::ranges::sort(sorted);
+        for (double q : { 0.01, 0.1, 0.5, 0.9, 0.99 }) {
+            double const exact = sorted[static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1))];
+            double const estimate = single_sketch.quantile(q);
+            CHECK(std::abs(estimate - exact) <= QuantileSketch::RELATIVE_ACCURACY * exact + 1e-12);
+        }
+        CHECK(single_sketch.quantile(0.0) == 0.0);
+    }
+
+    // The Wilson interval holds the observed proportion and stays inside [0, 1]
+    {
+        Interval const none = wilson_interval(0, 0);
+        CHECK(none.low == 0.0 && none.high == 1.0);
+        Interval const zero = wilson_interval(0, 20);
+        CHECK(zero.low == 0.0 && zero.high > 0.0 && zero.high < 0.2);
+        Interval const all = wilson_interval(20, 20);
+        CHECK(all.high == 1.0 && all.low > 0.8 && all.low < 1.0);
+        Interval const half = wilson_interval(50, 100);
+        CHECK(close(half.low + half.high, 1.0));
+        // 95% interval of 50 successes in 100: 0.4038 to 0.5962
+        CHECK(std::abs(half.low - 0.4038) < 1e-4 && std::abs(half.high - 0.5962) < 1e-4);
+        Interval const narrower = wilson_interval(500, 1000);
+        CHECK(narrower.low > half.low && narrower.high < half.high);
+    }
+
+    // The sequential test stops at its bounds and accepts the hypothesis the scores come from
+    {
+        CHECK(refused(0.5, 0.5, 0.05, 0.05));
+        CHECK(refused(0.5, 0.55, 0.0, 0.05));
+        CHECK(refused(0.5, 0.55, 0.05, 1.0));
+        CHECK(!refused(0.5, 0.55, 0.05, 0.05));
+
+        Sprt const test(0.5, 0.55, 0.05, 0.1);
+        CHECK(close(test.lower_bound(), std::log(0.1 / 0.95)));
+        CHECK(close(test.upper_bound(), std::log(0.9 / 0.05)));
+
+        RunningStats one;
+        one.add(1.0);
+        CHECK(test.llr(one) == 0.0 && test.decide(one) == Sprt::Decision::CONTINUE);
+
+        // Scores halfway between the hypotheses favour neither
+        RunningStats halfway;
+        for (int i = 0; i < 1000; ++i) {
+            halfway.add(i % 40 < 21 ? 1.0 : 0.0);
+        }
+        CHECK(std::abs(halfway.mean() - 0.525) < 1e-12);
+        CHECK(std::abs(test.llr(halfway)) < 1e-9);
+        CHECK(test.decide(halfway) == Sprt::Decision::CONTINUE);
+        CHECK(close(Sprt(0.55, 0.5, 0.05, 0.1).llr(halfway), -test.llr(halfway)));
+
+        CHECK(run(test, 0.45, 100000) == Sprt::Decision::ACCEPT_H0);
+        CHECK(run(test, 0.65, 100000) == Sprt::Decision::ACCEPT_H1);
+
+        // Scores that never vary still decide, on the side of their mean
+        RunningStats constant;
+        constant.add(1.0);
+        constant.add(1.0);
+        CHECK(test.decide(constant) == Sprt::Decision::ACCEPT_H1);
+    }
+    return Check::result();
+}